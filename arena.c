@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Region allocator
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+#define ARENA_CHUNK_SIZE (64 * 1024)
+#define ARENA_ALIGN (sizeof(max_align_t))
+
+struct chunk {
+	struct chunk *next;
+	size_t size;
+	size_t used;
+	max_align_t data[];
+};
+
+struct arena {
+	/* Most recent first, so that allocations come from the head */
+	struct chunk *chunks;
+	/* Kept across arena_reset() */
+	struct chunk *first;
+};
+
+static struct chunk *
+chunk_create(size_t size)
+{
+	struct chunk *chunk = malloc(sizeof(*chunk) + size);
+	if (!chunk) {
+		fprintf(stderr, "fatal: cannot allocate");
+		exit(EXIT_FAILURE);
+	}
+	chunk->next = NULL;
+	chunk->size = size;
+	chunk->used = 0;
+	return chunk;
+}
+
+struct arena *
+arena_create(void)
+{
+	struct arena *arena = calloc(1, sizeof(*arena));
+	arena->chunks = chunk_create(ARENA_CHUNK_SIZE);
+	arena->first = arena->chunks;
+	return arena;
+}
+
+static void
+free_chunks(struct chunk *chunk)
+{
+	while (chunk) {
+		struct chunk *next = chunk->next;
+		free(chunk);
+		chunk = next;
+	}
+}
+
+void
+arena_destroy(struct arena *arena)
+{
+	if (!arena) {
+		return;
+	}
+	free_chunks(arena->chunks);
+	free(arena);
+}
+
+void
+arena_reset(struct arena *arena)
+{
+	struct chunk *chunk = arena->chunks;
+	while (chunk) {
+		struct chunk *next = chunk->next;
+		if (chunk != arena->first) {
+			free(chunk);
+		}
+		chunk = next;
+	}
+	arena->first->next = NULL;
+	arena->first->used = 0;
+	arena->chunks = arena->first;
+}
+
+/* Chunks are aligned to ARENA_ALIGN, so only offsets need aligning */
+static void *
+alloc(struct arena *arena, size_t size, size_t align)
+{
+	struct chunk *chunk = arena->chunks;
+	size_t offset = (chunk->used + align - 1) & ~(align - 1);
+	if (offset <= chunk->size && chunk->size - offset >= size) {
+		chunk->used = offset + size;
+		return (char *)chunk->data + offset;
+	}
+
+	/*
+	 * Large allocations get a chunk of their own behind the current one,
+	 * so that the space left in the current chunk is not wasted.
+	 */
+	if (size > ARENA_CHUNK_SIZE / 4) {
+		struct chunk *large = chunk_create(size);
+		large->used = size;
+		large->next = chunk->next;
+		chunk->next = large;
+		return large->data;
+	}
+
+	chunk = chunk_create(ARENA_CHUNK_SIZE);
+	chunk->next = arena->chunks;
+	arena->chunks = chunk;
+	chunk->used = size;
+	return chunk->data;
+}
+
+void *
+arena_alloc(struct arena *arena, size_t size)
+{
+	return alloc(arena, size, ARENA_ALIGN);
+}
+
+void *
+arena_alloc_bytes(struct arena *arena, size_t size)
+{
+	return alloc(arena, size, 1);
+}
+
+char *
+arena_strdup(struct arena *arena, const char *s)
+{
+	if (!s) {
+		return NULL;
+	}
+	size_t len = strlen(s) + 1;
+	char *p = arena_alloc_bytes(arena, len);
+	memcpy(p, s, len);
+	return p;
+}
@@ -0,0 +1,30 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef ARENA_H
+#define ARENA_H
+#include <stddef.h>
+
+/*
+ * A region allocator. Memory is handed out by bumping a pointer through
+ * large chunks and is only ever released all at once, either by
+ * arena_reset() which keeps the first chunk for the next round, or by
+ * arena_destroy(). An arena is not thread-safe.
+ */
+struct arena;
+
+struct arena *arena_create(void);
+void arena_destroy(struct arena *arena);
+void arena_reset(struct arena *arena);
+
+/* arena_alloc - return @size bytes of uninitialized memory */
+void *arena_alloc(struct arena *arena, size_t size);
+
+/*
+ * arena_alloc_bytes - like arena_alloc() but without alignment, so that
+ * strings and other byte data are packed tightly
+ */
+void *arena_alloc_bytes(struct arena *arena, size_t size);
+
+/* arena_strdup - copy @s into the arena, or return NULL if @s is NULL */
+char *arena_strdup(struct arena *arena, const char *s);
+
+#endif /* ARENA_H */
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Manifests listing the menus to write in one run
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <glib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "batch.h"
+#include "render.h"
+
+static void
+target_free(struct batch_target *target)
+{
+	g_free(target->output);
+	g_free(target->request);
+	g_free(target->lang);
+	g_free(target);
+}
+
+static bool
+is_option(const char *arg, char c, const char *name)
+{
+	return (arg[0] == '-' && arg[1] == c && !arg[2]) || !strcmp(arg, name);
+}
+
+/* Returns false if @arg is not one of the menu options without a value */
+static bool
+set_flag(struct labwc_menu_options *options, const char *arg)
+{
+	if (is_option(arg, 'b', "--bare")) {
+		options->bare = true;
+	} else if (is_option(arg, 'd', "--desktop")) {
+		options->desktop_filename = true;
+	} else if (is_option(arg, 'e', "--check-exec")) {
+		options->check_exec = true;
+	} else if (is_option(arg, 'I', "--icons")) {
+		options->icons = true;
+	} else if (is_option(arg, 'n', "--no-duplicates")) {
+		options->no_duplicates = true;
+	} else if (is_option(arg, 'p', "--pipemenu")) {
+		options->pipemenu = true;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+static struct batch_target *
+parse_target(char **argv, const char **error)
+{
+	struct labwc_menu_options options = { 0 };
+	const char *lang = NULL;
+	for (char **arg = argv + 1; *arg; arg++) {
+		if (set_flag(&options, *arg)) {
+			continue;
+		}
+		if (g_str_has_prefix(*arg, "--format=")) {
+			if (!render_format_lookup(*arg + strlen("--format="),
+					&options.format)) {
+				*error = "unknown format";
+				return NULL;
+			}
+		} else if (g_str_has_prefix(*arg, "LANG=")) {
+			lang = *arg + strlen("LANG=");
+		} else if (g_str_has_prefix(*arg, "--terminal-prefix=")) {
+			options.terminal_prefix = *arg
+				+ strlen("--terminal-prefix=");
+		} else if (!strcmp(*arg, "-t")
+				|| !strcmp(*arg, "--terminal-prefix")) {
+			if (!arg[1]) {
+				*error = "missing terminal prefix";
+				return NULL;
+			}
+			options.terminal_prefix = *++arg;
+		} else {
+			*error = "unknown option";
+			return NULL;
+		}
+	}
+
+	struct batch_target *target = g_new0(struct batch_target, 1);
+	target->output = g_strdup(argv[0]);
+	target->request = render_request_create(&options);
+	target->lang = lang && *lang ? g_strdup(lang) : NULL;
+	return target;
+}
+
+GPtrArray *
+batch_load(const char *filename)
+{
+	char *contents;
+	GError *err = NULL;
+	if (!g_file_get_contents(filename, &contents, NULL, &err)) {
+		fprintf(stderr, "fatal: %s\n", err->message);
+		g_error_free(err);
+		return NULL;
+	}
+
+	GPtrArray *targets = g_ptr_array_new_with_free_func(
+		(GDestroyNotify)target_free);
+	char **lines = g_strsplit(contents, "\n", -1);
+	g_free(contents);
+	for (int i = 0; lines[i]; i++) {
+		char *line = g_strstrip(lines[i]);
+		if (!*line || *line == '#') {
+			continue;
+		}
+		int argc;
+		char **argv;
+		const char *error = NULL;
+		struct batch_target *target = NULL;
+		if (!g_shell_parse_argv(line, &argc, &argv, NULL)) {
+			error = "bad quoting";
+		} else {
+			target = parse_target(argv, &error);
+			g_strfreev(argv);
+		}
+		if (!target) {
+			fprintf(stderr, "fatal: %s:%d: %s\n", filename, i + 1,
+				error);
+			g_ptr_array_free(targets, TRUE);
+			targets = NULL;
+			break;
+		}
+		g_ptr_array_add(targets, target);
+	}
+	g_strfreev(lines);
+	return targets;
+}
@@ -0,0 +1,27 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef BATCH_H
+#define BATCH_H
+#include <glib.h>
+
+/*
+ * A --batch manifest lists one menu per line:
+ *   <output> [LANG=<lang>] [options...]
+ * <output> is a file, or - for stdout, and the options are the menu options
+ * of the command line. Words are split and quoted like in the shell. Blank
+ * lines and lines starting with # are skipped.
+ */
+struct batch_target {
+	char *output;
+	/* The menu options encoded as a daemon request */
+	char *request;
+	/* $LANG for the menu, or NULL for that of the process */
+	char *lang;
+};
+
+/*
+ * batch_load - parse the manifest @filename into a list of targets, or
+ * return NULL after saying what is wrong with it
+ */
+GPtrArray *batch_load(const char *filename);
+
+#endif /* BATCH_H */
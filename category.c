@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Map category names to bits
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <string.h>
+#include "category.h"
+#include "schema.h"
+
+uint64_t
+category_set_lookup(const char *list)
+{
+	uint64_t set = 0;
+	if (!list) {
+		return set;
+	}
+	while (*list) {
+		size_t len = strcspn(list, ";");
+		/* Lists usually end with a semi-colon, giving an empty name */
+		int bit = len ? schema_category_lookup(list, len) : -1;
+		if (bit >= 0) {
+			set |= UINT64_C(1) << bit;
+		}
+		list += len;
+		if (*list == ';') {
+			list++;
+		}
+	}
+	return set;
+}
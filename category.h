@@ -0,0 +1,18 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef CATEGORY_H
+#define CATEGORY_H
+#include <stdint.h>
+
+/*
+ * Categories are bits of a 64-bit set, numbered at build time by the
+ * schema, so that matching the categories of an app against those of a
+ * directory is a single AND. See schema_dirs[].category_set.
+ */
+
+/*
+ * category_set_lookup - get the set of schema categories in the ;-separated
+ * @list. Any others are dropped as no directory can match them.
+ */
+uint64_t category_set_lookup(const char *list);
+
+#endif /* CATEGORY_H */
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Locale-aware sort keys
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <glib.h>
+#include <locale.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "collate.h"
+
+static bool
+is_ascii(const char *s)
+{
+	for (; *s; s++) {
+		if ((unsigned char)*s >= 0x80) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Whether LC_COLLATE is C, or -1 if it has not been looked at yet */
+static gint c_collation = -1;
+
+/* The C and C.UTF-8 locales collate by code point, just like strcmp() */
+static bool
+is_c_collation(void)
+{
+	gint c = g_atomic_int_get(&c_collation);
+	if (c < 0) {
+		const char *locale = setlocale(LC_COLLATE, NULL);
+		c = !locale || !strcmp(locale, "POSIX")
+			|| !strcmp(locale, "C") || !strncmp(locale, "C.", 2);
+		g_atomic_int_set(&c_collation, c);
+	}
+	return c;
+}
+
+void
+collate_locale_changed(void)
+{
+	g_atomic_int_set(&c_collation, -1);
+}
+
+char *
+collate_key_create(const char *name)
+{
+	/*
+	 * We casefold before collating so that the order in the C locale is
+	 * the same as ever, and languages other than English still sort
+	 * their letters correctly. Most names are plain ASCII, which does
+	 * not need the Unicode tables.
+	 */
+	char *folded = is_ascii(name) ?
+		g_ascii_strdown(name, -1) : g_utf8_casefold(name, -1);
+	if (is_c_collation()) {
+		return folded;
+	}
+	char *key = g_utf8_collate_key(folded, -1);
+	g_free(folded);
+	return key;
+}
+
+struct sort_entry {
+	const char *key;
+	guint index;
+	void *item;
+};
+
+static int
+compare_entry(const void *a, const void *b)
+{
+	const struct sort_entry *aa = a;
+	const struct sort_entry *bb = b;
+	int ret = strcmp(aa->key, bb->key);
+	if (ret) {
+		return ret;
+	}
+	return aa->index < bb->index ? -1 : aa->index > bb->index;
+}
+
+void
+collate_list_sort(GList *list, const char *(*get_key)(const void *item))
+{
+	guint n = g_list_length(list);
+	if (n < 2) {
+		return;
+	}
+	struct sort_entry *entries = g_new(struct sort_entry, n);
+	guint i = 0;
+	for (GList *iter = list; iter; iter = iter->next, i++) {
+		entries[i].key = get_key(iter->data);
+		entries[i].index = i;
+		entries[i].item = iter->data;
+	}
+	qsort(entries, n, sizeof(*entries), compare_entry);
+
+	/* The links stay where they are and only their items move */
+	i = 0;
+	for (GList *iter = list; iter; iter = iter->next, i++) {
+		iter->data = entries[i].item;
+	}
+	g_free(entries);
+}
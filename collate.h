@@ -0,0 +1,22 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef COLLATE_H
+#define COLLATE_H
+#include <glib.h>
+
+/*
+ * collate_key_create - get a key which sorts @name case-insensitively in the
+ * order of the LC_COLLATE locale when compared with strcmp(). Free with
+ * g_free().
+ */
+char *collate_key_create(const char *name);
+
+/* collate_locale_changed - call after LC_COLLATE has been set again */
+void collate_locale_changed(void);
+
+/*
+ * collate_list_sort - sort @list by the keys which @get_key returns for its
+ * items. Equal keys keep their order.
+ */
+void collate_list_sort(GList *list, const char *(*get_key)(const void *item));
+
+#endif /* COLLATE_H */
@@ -0,0 +1,518 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Serve menus from memory over a UNIX socket
+ *
+ * The daemon watches the scanned directories and the ignore file with
+ * inotify and marks the model stale when a .desktop file, a subdirectory,
+ * a program in $PATH or the ignore file changes. Applications directories
+ * which do not exist yet are noticed through the nearest parent directory
+ * that does, by their name. The model is rebuilt on the next request, which
+ * only reads the listings of the directories and re-parses the files that
+ * have changed thanks to the parse cache.
+ *
+ * Clients send the id of their environment along with the request. Menus
+ * also depend on $LANG, $PATH and the like and on which ignore file is
+ * used, so the daemon turns down clients whose id differs from its own and
+ * they generate the menu themselves. The reply is REPLY_MENU followed by
+ * the menu, which may be empty, or REPLY_REFUSED.
+ */
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include <errno.h>
+#include <glib.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#ifdef HAVE_INOTIFY
+#include <sys/inotify.h>
+#endif
+#include "daemon.h"
+#include "desktop.h"
+#include "labwc-menu-private.h"
+#include "menu-cache.h"
+
+#define REQUEST_MAX 4096
+#define REPLY_MENU '+'
+#define REPLY_REFUSED '-'
+
+static volatile sig_atomic_t quit;
+
+static void
+handle_signal(int signum)
+{
+	(void)signum;
+	quit = 1;
+}
+
+static bool
+socket_address(struct sockaddr_un *addr)
+{
+	char *path = g_build_filename(g_get_user_runtime_dir(),
+		"labwc-menu-generator.sock", NULL);
+	memset(addr, 0, sizeof(*addr));
+	addr->sun_family = AF_UNIX;
+	bool fits = strlen(path) < sizeof(addr->sun_path);
+	if (fits) {
+		strcpy(addr->sun_path, path);
+	} else {
+		fprintf(stderr, "warn: socket path too long '%s'\n", path);
+	}
+	g_free(path);
+	return fits;
+}
+
+static bool
+write_all(int fd, const char *buf, size_t len)
+{
+	while (len) {
+		ssize_t n = write(fd, buf, len);
+		if (n == -1 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			return false;
+		}
+		buf += n;
+		len -= n;
+	}
+	return true;
+}
+
+/* A digest of the environment and the ignore file that menus depend on */
+static char *
+environment_id(const char *ignore_file)
+{
+	GChecksum *checksum = g_checksum_new(G_CHECKSUM_SHA256);
+	menu_cache_checksum_environment(checksum);
+	char *path = ignore_file && *ignore_file
+		? realpath(ignore_file, NULL) : NULL;
+	const char *s = path ? path : ignore_file ? ignore_file : "";
+	g_checksum_update(checksum, (const guchar *)s, strlen(s) + 1);
+	free(path);
+	char *id = g_strdup(g_checksum_get_string(checksum));
+	g_checksum_free(checksum);
+	return id;
+}
+
+bool
+daemon_connect(const char *request, const char *ignore_file)
+{
+	struct sockaddr_un addr;
+	if (!socket_address(&addr)) {
+		return false;
+	}
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd == -1) {
+		return false;
+	}
+	if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1) {
+		close(fd);
+		return false;
+	}
+	char *id = environment_id(ignore_file);
+	char *line = g_strdup_printf("%s %s\n", id, request);
+	bool ok = write_all(fd, line, strlen(line));
+	g_free(line);
+	g_free(id);
+	if (!ok) {
+		close(fd);
+		return false;
+	}
+	shutdown(fd, SHUT_WR);
+
+	/* Nothing has been written yet if we were turned down */
+	char status = REPLY_REFUSED;
+	ssize_t n;
+	while ((n = read(fd, &status, 1)) == -1 && errno == EINTR) {
+		;
+	}
+	if (n != 1 || status != REPLY_MENU) {
+		close(fd);
+		return false;
+	}
+
+	char buf[65536];
+	fflush(stdout);
+	while ((n = read(fd, buf, sizeof(buf))) != 0) {
+		if (n == -1 && errno == EINTR) {
+			continue;
+		}
+		if (n == -1 || !write_all(STDOUT_FILENO, buf, n)) {
+			break;
+		}
+	}
+	close(fd);
+	return true;
+}
+
+static int
+listen_on_socket(void)
+{
+	struct sockaddr_un addr;
+	if (!socket_address(&addr)) {
+		return -1;
+	}
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd == -1) {
+		return -1;
+	}
+
+	/* A socket which nobody answers on is left over from a dead daemon */
+	if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+		fprintf(stderr, "fatal: daemon already running on '%s'\n",
+			addr.sun_path);
+		close(fd);
+		return -1;
+	}
+	unlink(addr.sun_path);
+
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1
+			|| listen(fd, 16) == -1) {
+		fprintf(stderr, "fatal: cannot listen on '%s'\n", addr.sun_path);
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+static char *
+read_request(int fd)
+{
+	/* Do not let a silent client hold up everybody else */
+	struct timeval timeout = { .tv_sec = 1 };
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	char buf[REQUEST_MAX];
+	size_t len = 0;
+	while (len < sizeof(buf) - 1) {
+		ssize_t n = read(fd, buf + len, sizeof(buf) - 1 - len);
+		if (n == -1 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			break;
+		}
+		len += n;
+		if (memchr(buf, '\n', len)) {
+			break;
+		}
+	}
+	char *p = memchr(buf, '\n', len);
+	if (!p) {
+		return NULL;
+	}
+	*p = '\0';
+	return g_strdup(buf);
+}
+
+static void
+free_menu(gpointer menu)
+{
+	g_string_free(menu, TRUE);
+}
+
+/*
+ * What the events in a watched directory can change: its .desktop files
+ * and subdirectories if it is an applications directory, or its programs
+ * if it is in $PATH. Directories which are the nearest existing parent of
+ * missing applications directories also have the names that lead to them.
+ * Any event on the ignore file or on a directory itself matters.
+ */
+enum watch_flags {
+	WATCH_APPLICATIONS = 1 << 0,
+	WATCH_PROGRAMS = 1 << 1,
+};
+
+struct watch {
+	unsigned int flags;
+	GHashTable *children;
+};
+
+static void
+free_watch(gpointer data)
+{
+	struct watch *watch = data;
+	if (watch->children) {
+		g_hash_table_destroy(watch->children);
+	}
+	g_free(watch);
+}
+
+#ifdef HAVE_INOTIFY
+static struct watch *
+add_watch(GHashTable *watches, int inotify_fd, const char *path,
+		uint32_t mask)
+{
+	int wd = inotify_add_watch(inotify_fd, path, mask);
+	if (wd == -1) {
+		return NULL;
+	}
+	struct watch *watch = g_hash_table_lookup(watches, GINT_TO_POINTER(wd));
+	if (!watch) {
+		watch = g_new0(struct watch, 1);
+		g_hash_table_insert(watches, GINT_TO_POINTER(wd), watch);
+	}
+	return watch;
+}
+
+static bool
+is_applications_dir(GPtrArray *paths, const char *dir)
+{
+	for (guint i = 0; i < paths->len; i++) {
+		if (g_str_has_prefix(dir, g_ptr_array_index(paths, i))) {
+			return true;
+		}
+	}
+	return false;
+}
+#endif
+
+/*
+ * The watches are replaced by those of @dirs and @ignore_file. Watches on
+ * the directories which are no longer scanned are left in place, but
+ * their events are ignored.
+ */
+static void
+watch_directories(int inotify_fd, GHashTable *watches, GPtrArray *dirs,
+		const char *ignore_file)
+{
+	g_hash_table_remove_all(watches);
+#ifdef HAVE_INOTIFY
+	const uint32_t mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO
+		| IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF;
+	GPtrArray *paths = desktop_search_paths_create();
+	GHashTable *scanned = g_hash_table_new(g_str_hash, g_str_equal);
+	for (guint i = 0; i < dirs->len; i++) {
+		char *dir = g_ptr_array_index(dirs, i);
+		struct watch *watch = add_watch(watches, inotify_fd, dir, mask);
+		if (watch) {
+			watch->flags |= is_applications_dir(paths, dir)
+				? WATCH_APPLICATIONS : WATCH_PROGRAMS;
+		}
+		g_hash_table_add(scanned, dir);
+	}
+
+	/* The mask is added to that of any directory which is also scanned */
+	for (guint i = 0; i < paths->len; i++) {
+		char *path = g_ptr_array_index(paths, i);
+		if (g_hash_table_contains(scanned, path)
+				|| access(path, F_OK) == 0) {
+			continue;
+		}
+		char *missing = g_strdup(path);
+		char *parent = g_path_get_dirname(missing);
+		while (access(parent, F_OK) == -1) {
+			char *dirname = g_path_get_dirname(parent);
+			if (!strcmp(dirname, parent)) {
+				g_free(dirname);
+				break;
+			}
+			g_free(missing);
+			missing = parent;
+			parent = dirname;
+		}
+		struct watch *watch = add_watch(watches, inotify_fd, parent,
+			IN_CREATE | IN_MOVED_TO | IN_MASK_ADD);
+		if (watch) {
+			if (!watch->children) {
+				watch->children = g_hash_table_new_full(
+					g_str_hash, g_str_equal, g_free, NULL);
+			}
+			g_hash_table_add(watch->children,
+				g_path_get_basename(missing));
+		}
+		g_free(parent);
+		g_free(missing);
+	}
+	g_hash_table_destroy(scanned);
+	g_ptr_array_free(paths, TRUE);
+
+	if (ignore_file && *ignore_file) {
+		add_watch(watches, inotify_fd, ignore_file, mask);
+	}
+#else
+	(void)inotify_fd;
+	(void)dirs;
+	(void)ignore_file;
+#endif
+}
+
+#ifdef HAVE_INOTIFY
+/*
+ * Returns true if @event may change the menus. Other files come and go in
+ * the parents of missing directories, and the contents of programs do not
+ * matter.
+ */
+static bool
+is_relevant(GHashTable *watches, const struct inotify_event *event)
+{
+	if (event->mask & IN_Q_OVERFLOW) {
+		return true;
+	}
+	struct watch *watch = g_hash_table_lookup(watches,
+		GINT_TO_POINTER(event->wd));
+	if (!watch) {
+		return false;
+	}
+
+	/* The watched directory or file itself changed or went away */
+	if (!event->len) {
+		return true;
+	}
+	const char *name = event->name;
+	if (watch->children && g_hash_table_contains(watch->children, name)) {
+		return true;
+	}
+	if ((watch->flags & WATCH_APPLICATIONS) && ((event->mask & IN_ISDIR)
+			|| g_str_has_suffix(name, ".desktop"))) {
+		return true;
+	}
+	return (watch->flags & WATCH_PROGRAMS)
+		&& !(event->mask & IN_CLOSE_WRITE);
+}
+#endif
+
+/* Returns true if any of the pending events may change the menus */
+static bool
+read_events(int inotify_fd, GHashTable *watches)
+{
+#ifdef HAVE_INOTIFY
+	bool is_stale = false;
+	_Alignas(struct inotify_event) char buf[4096];
+	ssize_t len;
+	while ((len = read(inotify_fd, buf, sizeof(buf))) > 0) {
+		for (char *p = buf; p < buf + len;) {
+			struct inotify_event *event = (struct inotify_event *)p;
+			is_stale |= is_relevant(watches, event);
+			p += sizeof(*event) + event->len;
+		}
+	}
+	return is_stale;
+#else
+	(void)inotify_fd;
+	(void)watches;
+	return true;
+#endif
+}
+
+static void
+reload(struct labwc_menu *menu, const char *ignore_file, int inotify_fd,
+		GHashTable *watches)
+{
+	labwc_menu_scan(menu);
+	watch_directories(inotify_fd, watches, labwc_menu_scanned_dirs(menu),
+		ignore_file);
+}
+
+int
+daemon_run(struct labwc_menu *menu, const char *ignore_file)
+{
+	int listen_fd = listen_on_socket();
+	if (listen_fd == -1) {
+		return EXIT_FAILURE;
+	}
+
+	struct sigaction sa = { .sa_handler = handle_signal };
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	int inotify_fd = -1;
+#ifdef HAVE_INOTIFY
+	inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotify_fd == -1) {
+		fprintf(stderr, "warn: inotify unavailable; rescanning per request\n");
+	}
+#endif
+
+	char *id = environment_id(ignore_file);
+	size_t id_len = strlen(id);
+	GHashTable *menus = g_hash_table_new_full(g_str_hash, g_str_equal,
+		g_free, free_menu);
+	GHashTable *watches = g_hash_table_new_full(g_direct_hash,
+		g_direct_equal, NULL, free_watch);
+	reload(menu, ignore_file, inotify_fd, watches);
+	bool stale = false;
+
+	while (!quit) {
+		struct pollfd fds[2] = {
+			{ .fd = listen_fd, .events = POLLIN },
+			{ .fd = inotify_fd, .events = POLLIN },
+		};
+		if (poll(fds, inotify_fd == -1 ? 1 : 2, -1) == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+
+		if ((fds[1].revents & POLLIN)
+				&& read_events(inotify_fd, watches)) {
+			stale = true;
+		}
+
+		if (!(fds[0].revents & POLLIN)) {
+			continue;
+		}
+		int client = accept(listen_fd, NULL, NULL);
+		if (client == -1) {
+			continue;
+		}
+
+		/* Without inotify we cannot know when to rescan */
+		if (stale || inotify_fd == -1) {
+			reload(menu, ignore_file, inotify_fd, watches);
+			g_hash_table_remove_all(menus);
+			stale = false;
+		}
+
+		char *line = read_request(client);
+		if (line && !strncmp(line, id, id_len) && line[id_len] == ' ') {
+			const char *request = line + id_len + 1;
+			GString *rendered = g_hash_table_lookup(menus, request);
+			if (!rendered) {
+				GPtrArray *dirs = labwc_menu_scanned_dirs(menu);
+				guint nr_dirs = dirs->len;
+				rendered = g_string_new(NULL);
+				labwc_menu_render_request(menu, rendered, request,
+					NULL);
+				g_hash_table_insert(menus, g_strdup(request),
+					rendered);
+
+				/* --check-exec may have read $PATH just now */
+				if (dirs->len != nr_dirs) {
+					watch_directories(inotify_fd, watches,
+						dirs, ignore_file);
+				}
+			}
+			if (write_all(client, &(char){ REPLY_MENU }, 1)) {
+				write_all(client, rendered->str, rendered->len);
+			}
+		} else {
+			write_all(client, &(char){ REPLY_REFUSED }, 1);
+		}
+		g_free(line);
+		close(client);
+	}
+
+	struct sockaddr_un addr;
+	if (socket_address(&addr)) {
+		unlink(addr.sun_path);
+	}
+	close(listen_fd);
+	if (inotify_fd != -1) {
+		close(inotify_fd);
+	}
+	g_hash_table_destroy(menus);
+	g_hash_table_destroy(watches);
+	g_free(id);
+	return EXIT_SUCCESS;
+}
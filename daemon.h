@@ -0,0 +1,25 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef DAEMON_H
+#define DAEMON_H
+#include <glib.h>
+#include <stdbool.h>
+
+struct labwc_menu;
+
+/*
+ * daemon_run - keep the parsed .desktop files of @menu in memory and serve
+ * rendered menus on a UNIX socket until SIGINT or SIGTERM is received.
+ * A request is a line holding the id of the client's environment, a space
+ * and the string of menu options built by the client, for example "bIp" or
+ * "nttfoot". Rendered menus are cached per request.
+ */
+int daemon_run(struct labwc_menu *menu, const char *ignore_file);
+
+/*
+ * daemon_connect - write the menu served by a running daemon to stdout
+ * Returns false, without writing anything, if no daemon could be reached or
+ * if it was started in another environment or with another @ignore_file.
+ */
+bool daemon_connect(const char *request, const char *ignore_file);
+
+#endif /* DAEMON_H */
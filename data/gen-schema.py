@@ -0,0 +1,205 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-2.0-only
+"""
+Compile the directory schema into C tables
+
+Usage: gen-schema.py <schema.txt> <schema.c> <schema.h>
+
+Localized names are looked up by their "Name[ll_CC]" key and categories by
+their name through perfect hash tables, so that startup costs the same
+however many locales and directories the schema has.
+"""
+import sys
+
+FNV_PRIME = 16777619
+MAX_CATEGORIES = 64
+MAX_SEEDS = 1000
+
+
+def fnv1a(s, seed):
+    h = seed
+    for b in s.encode('utf-8'):
+        h = ((h ^ b) * FNV_PRIME) & 0xffffffff
+    return h
+
+
+def perfect_hash(keys):
+    """Find the smallest table and a seed which map @keys without collision"""
+    size = 1
+    while size < len(keys):
+        size *= 2
+    while True:
+        for seed in range(MAX_SEEDS):
+            slots = [-1] * size
+            for i, key in enumerate(keys):
+                slot = fnv1a(key, seed) & (size - 1)
+                if slots[slot] >= 0:
+                    break
+                slots[slot] = i
+            else:
+                return seed, slots
+        size *= 2
+
+
+def c_string(s):
+    if s is None:
+        return 'NULL'
+    return '"' + s.replace('\\', '\\\\').replace('"', '\\"') + '"'
+
+
+def parse(filename):
+    dirs = []
+    with open(filename, encoding='utf-8') as f:
+        for n, line in enumerate(f, 1):
+            line = line.strip()
+            if not line or line.startswith('#'):
+                continue
+            key, sep, value = line.partition('=')
+            if not sep:
+                sys.exit(f'{filename}:{n}: expected key=value')
+            # The keyword 'Name' starts a new directory section
+            if key == 'Name':
+                dirs.append({'Name': value})
+            elif not dirs:
+                sys.exit(f'{filename}:{n}: expected Name= first')
+            else:
+                dirs[-1][key] = value
+    return dirs
+
+
+def main():
+    if len(sys.argv) != 4:
+        sys.exit('usage: gen-schema.py <schema.txt> <schema.c> <schema.h>')
+    dirs = parse(sys.argv[1])
+
+    locales = []
+    categories = []
+    for d in dirs:
+        for key in d:
+            if key.startswith('Name[') and key not in locales:
+                locales.append(key)
+        for category in d.get('Categories', '').split(';'):
+            if category and category not in categories:
+                categories.append(category)
+    if len(categories) > MAX_CATEGORIES:
+        sys.exit(f'more than {MAX_CATEGORIES} categories')
+
+    locale_seed, locale_slots = perfect_hash(locales)
+    category_seed, category_slots = perfect_hash(categories)
+
+    with open(sys.argv[3], 'w', encoding='utf-8') as h:
+        h.write(f'''/* Generated from schema.txt by gen-schema.py - do not edit */
+#ifndef SCHEMA_H
+#define SCHEMA_H
+#include <stddef.h>
+#include <stdint.h>
+
+#define SCHEMA_NR_DIRS {len(dirs)}
+
+struct schema_dir {{
+	const char *name;
+	const char *icon;
+	/* NULL for the directory of apps which fit in no other */
+	const char *categories;
+	/* The bits of @categories, see schema_category_lookup() */
+	uint64_t category_set;
+}};
+
+extern const struct schema_dir schema_dirs[SCHEMA_NR_DIRS];
+
+/* schema_locale_lookup - get the index of a "Name[ll_CC]" key, or -1 */
+int schema_locale_lookup(const char *key);
+
+/*
+ * schema_dir_name_localized - get the name of directory @dir in the locale
+ * returned by schema_locale_lookup(), or NULL if it is not translated
+ */
+const char *schema_dir_name_localized(int dir, int locale);
+
+/* schema_category_lookup - get the bit of the @len byte @name, or -1 */
+int schema_category_lookup(const char *name, size_t len);
+
+#endif /* SCHEMA_H */
+''')
+
+    with open(sys.argv[2], 'w', encoding='utf-8') as c:
+        c.write('''/* Generated from schema.txt by gen-schema.py - do not edit */
+#include <string.h>
+#include "schema.h"
+
+static uint32_t
+hash(const char *s, size_t len, uint32_t seed)
+{
+	uint32_t h = seed;
+	for (size_t i = 0; i < len; i++) {
+		h ^= (unsigned char)s[i];
+		h *= %du;
+	}
+	return h;
+}
+
+const struct schema_dir schema_dirs[SCHEMA_NR_DIRS] = {
+''' % FNV_PRIME)
+        for d in dirs:
+            category_set = 0
+            for category in d.get('Categories', '').split(';'):
+                if category:
+                    category_set |= 1 << categories.index(category)
+            c.write(f'\t{{ {c_string(d["Name"])}, {c_string(d.get("Icon"))}, '
+                    f'{c_string(d.get("Categories"))}, '
+                    f'UINT64_C(0x{category_set:x}) }},\n')
+        c.write('};\n\n')
+
+        c.write(f'static const char *const locales[{len(locales)}] = {{\n')
+        for key in locales:
+            c.write(f'\t{c_string(key)},\n')
+        c.write('};\n\n')
+
+        c.write(f'static const char *const names[{len(locales)}]'
+                '[SCHEMA_NR_DIRS] = {\n')
+        for key in locales:
+            values = ', '.join(c_string(d.get(key)) for d in dirs)
+            c.write(f'\t{{ {values} }},\n')
+        c.write('};\n\n')
+
+        c.write(f'static const char *const categories[{len(categories)}]'
+                ' = {\n')
+        for category in categories:
+            c.write(f'\t{c_string(category)},\n')
+        c.write('};\n\n')
+
+        for name, slots in (('locale_slots', locale_slots),
+                            ('category_slots', category_slots)):
+            c.write(f'static const int {name}[{len(slots)}] = {{\n')
+            for i in range(0, len(slots), 16):
+                row = ', '.join(str(s) for s in slots[i:i + 16])
+                c.write(f'\t{row},\n')
+            c.write('};\n\n')
+
+        c.write(f'''int
+schema_locale_lookup(const char *key)
+{{
+	uint32_t h = hash(key, strlen(key), {locale_seed}u);
+	int i = locale_slots[h & {len(locale_slots) - 1}];
+	return i >= 0 && !strcmp(locales[i], key) ? i : -1;
+}}
+
+const char *
+schema_dir_name_localized(int dir, int locale)
+{{
+	return names[locale][dir];
+}}
+
+int
+schema_category_lookup(const char *name, size_t len)
+{{
+	uint32_t h = hash(name, len, {category_seed}u);
+	int i = category_slots[h & {len(category_slots) - 1}];
+	return i >= 0 && !strncmp(categories[i], name, len)
+		&& !categories[i][len] ? i : -1;
+}}
+''')
+
+
+if __name__ == '__main__':
+    main()
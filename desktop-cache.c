@@ -0,0 +1,512 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Persistent cache of parsed .desktop files
+ *
+ * The cache lives in $XDG_CACHE_HOME/labwc-menu-generator/ and is mapped into
+ * memory in one go. It is written in native byte order because it is only
+ * ever read on the machine that wrote it.
+ *
+ * Layout:
+ *   header:     magic[8] version:u32 lang:str fields:u32 nr_dirs:u32
+ *   directory:  path:str mtime:i64 mtime_nsec:i64 nr_entries:u32
+ *   entry:      type:u8 name:str
+ *   file entry: ino:u64 size:i64 mtime:i64 mtime_nsec:i64
+ *   app entry:  name:str name_localized:str name_translations:str
+ *               generic_name:str generic_name_localized:str exec:str
+ *               tryexec:str working_dir:str icon:str categories:str
+ *               flags:u8
+ *
+ * A str is a u32 length (UINT32_MAX for NULL) followed by the bytes and a
+ * NUL terminator so that it can be used in place.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <glib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "desktop.h"
+#include "desktop-cache.h"
+
+#define CACHE_MAGIC "LMGCACHE"
+#define CACHE_VERSION 3
+#define CACHE_FILENAME "desktop-entries"
+
+#define APP_FLAG_NODISPLAY (1 << 0)
+#define APP_FLAG_TERMINAL (1 << 1)
+
+/* An entry of the mapped cache file */
+struct cached_entry {
+	enum cache_entry_type type;
+	const char *name;
+	uint64_t ino;
+	int64_t size, mtime, mtime_nsec;
+	const char *app;
+};
+
+/* A directory of the mapped cache file */
+struct cached_dir {
+	int64_t mtime, mtime_nsec;
+	GHashTable *entries;
+	const char **names;
+	uint8_t *types;
+};
+
+/* An entry recorded during this run */
+struct record {
+	enum cache_entry_type type;
+	char *name;
+	uint64_t ino;
+	int64_t size, mtime, mtime_nsec;
+	struct app *app;
+};
+
+/* A directory recorded during this run */
+struct cache_dir {
+	struct desktop_cache *cache;
+	char *path;
+	int64_t mtime, mtime_nsec;
+	struct cached_dir *cached;
+	GArray *records;
+};
+
+struct desktop_cache {
+	char *map;
+	size_t map_size;
+	GHashTable *cached_dirs;
+	GPtrArray *dirs;
+	char *lang;
+	/* The enum app_field bits of the apps in the cache */
+	unsigned int fields;
+	bool dirty;
+};
+
+struct reader {
+	const char *p, *end;
+	bool error;
+};
+
+static bool
+get(struct reader *r, void *dest, size_t len)
+{
+	if (r->error || (size_t)(r->end - r->p) < len) {
+		r->error = true;
+		memset(dest, 0, len);
+		return false;
+	}
+	memcpy(dest, r->p, len);
+	r->p += len;
+	return true;
+}
+
+static uint32_t
+get_u32(struct reader *r)
+{
+	uint32_t v;
+	get(r, &v, sizeof(v));
+	return v;
+}
+
+static int64_t
+get_i64(struct reader *r)
+{
+	int64_t v;
+	get(r, &v, sizeof(v));
+	return v;
+}
+
+static const char *
+get_str(struct reader *r)
+{
+	uint32_t len = get_u32(r);
+	if (r->error || len == UINT32_MAX) {
+		return NULL;
+	}
+	if ((size_t)(r->end - r->p) <= len || r->p[len] != '\0') {
+		r->error = true;
+		return NULL;
+	}
+	const char *s = r->p;
+	r->p += len + 1;
+	return s;
+}
+
+static void
+put_u32(GString *buf, uint32_t v)
+{
+	g_string_append_len(buf, (char *)&v, sizeof(v));
+}
+
+static void
+put_i64(GString *buf, int64_t v)
+{
+	g_string_append_len(buf, (char *)&v, sizeof(v));
+}
+
+static void
+put_str(GString *buf, const char *s)
+{
+	if (!s) {
+		put_u32(buf, UINT32_MAX);
+		return;
+	}
+	size_t len = strlen(s);
+	put_u32(buf, len);
+	g_string_append_len(buf, s, len + 1);
+}
+
+static char *
+cache_filename(void)
+{
+	return g_build_filename(g_get_user_cache_dir(), "labwc-menu-generator",
+		CACHE_FILENAME, NULL);
+}
+
+static void
+cached_dir_free(struct cached_dir *dir)
+{
+	g_hash_table_destroy(dir->entries);
+	g_free(dir->names);
+	g_free(dir->types);
+	g_free(dir);
+}
+
+static void
+skip_app(struct reader *r)
+{
+	for (int i = 0; i < 10; i++) {
+		get_str(r);
+	}
+	uint8_t flags;
+	get(r, &flags, sizeof(flags));
+}
+
+static bool
+parse_cache(struct desktop_cache *cache, unsigned int *fields)
+{
+	size_t map_size = cache->map_size;
+	struct reader r = { .p = cache->map, .end = cache->map + map_size };
+	char magic[8];
+
+	get(&r, magic, sizeof(magic));
+	if (memcmp(magic, CACHE_MAGIC, sizeof(magic))
+			|| get_u32(&r) != CACHE_VERSION
+			|| g_strcmp0(get_str(&r), cache->lang)) {
+		return false;
+	}
+	*fields = get_u32(&r);
+	if (r.error) {
+		*fields = 0;
+		return false;
+	}
+	if (cache->fields & ~*fields) {
+		return false;
+	}
+
+	uint32_t nr_dirs = get_u32(&r);
+	for (uint32_t i = 0; i < nr_dirs && !r.error; i++) {
+		const char *path = get_str(&r);
+		struct cached_dir *dir = calloc(1, sizeof(*dir));
+		dir->mtime = get_i64(&r);
+		dir->mtime_nsec = get_i64(&r);
+		dir->entries = g_hash_table_new_full(g_str_hash, g_str_equal,
+			NULL, g_free);
+		uint32_t nr_entries = get_u32(&r);
+		if (r.error || !path || nr_entries > map_size) {
+			cached_dir_free(dir);
+			return false;
+		}
+		dir->names = calloc(nr_entries + 1, sizeof(char *));
+		dir->types = calloc(nr_entries + 1, sizeof(uint8_t));
+		g_hash_table_replace(cache->cached_dirs, (char *)path, dir);
+
+		for (uint32_t j = 0; j < nr_entries && !r.error; j++) {
+			struct cached_entry *entry = calloc(1, sizeof(*entry));
+			uint8_t type;
+			get(&r, &type, sizeof(type));
+			entry->type = type;
+			entry->name = get_str(&r);
+			if (entry->type != CACHE_ENTRY_DIR) {
+				get(&r, &entry->ino, sizeof(entry->ino));
+				entry->size = get_i64(&r);
+				entry->mtime = get_i64(&r);
+				entry->mtime_nsec = get_i64(&r);
+			}
+			if (entry->type == CACHE_ENTRY_APP) {
+				entry->app = r.p;
+				skip_app(&r);
+			}
+			if (!entry->name) {
+				r.error = true;
+				g_free(entry);
+				break;
+			}
+			dir->names[j] = entry->name;
+			dir->types[j] = entry->type;
+			g_hash_table_replace(dir->entries, (char *)entry->name, entry);
+		}
+	}
+	return !r.error;
+}
+
+struct desktop_cache *
+desktop_cache_open(const char *lang, unsigned int fields)
+{
+	struct desktop_cache *cache = g_new0(struct desktop_cache, 1);
+	cache->lang = g_strdup(lang ? lang : "");
+	cache->fields = fields;
+	cache->dirs = g_ptr_array_new();
+	cache->cached_dirs = g_hash_table_new_full(g_str_hash, g_str_equal,
+		NULL, (GDestroyNotify)cached_dir_free);
+
+	char *filename = cache_filename();
+	int fd = open(filename, O_RDONLY);
+	g_free(filename);
+	if (fd == -1) {
+		return cache;
+	}
+	struct stat sb;
+	if (fstat(fd, &sb) == -1 || sb.st_size <= 0) {
+		close(fd);
+		return cache;
+	}
+	cache->map_size = sb.st_size;
+	cache->map = mmap(NULL, cache->map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (cache->map == MAP_FAILED) {
+		cache->map = NULL;
+		return cache;
+	}
+	/*
+	 * The fields of the cache are filled in for the files parsed in this
+	 * run too, so that runs with different options converge on one cache
+	 * which has them all
+	 */
+	unsigned int cached_fields = 0;
+	if (!parse_cache(cache, &cached_fields)) {
+		g_hash_table_remove_all(cache->cached_dirs);
+	}
+	cache->fields |= cached_fields;
+	return cache;
+}
+
+unsigned int
+desktop_cache_fields(struct desktop_cache *cache)
+{
+	return cache->fields;
+}
+
+static void
+write_app(GString *buf, struct app *app)
+{
+	put_str(buf, app->name);
+	put_str(buf, app->name_localized);
+	put_str(buf, app->name_translations);
+	put_str(buf, app->generic_name);
+	put_str(buf, app->generic_name_localized);
+	put_str(buf, app->exec);
+	put_str(buf, app->tryexec);
+	put_str(buf, app->working_dir);
+	put_str(buf, app->icon);
+	put_str(buf, app->categories);
+	uint8_t flags = (app->nodisplay ? APP_FLAG_NODISPLAY : 0)
+		| (app->terminal ? APP_FLAG_TERMINAL : 0);
+	g_string_append_len(buf, (char *)&flags, sizeof(flags));
+}
+
+static void
+write_cache(struct desktop_cache *cache)
+{
+	GPtrArray *dirs = cache->dirs;
+	/*
+	 * Anything modified in the last couple of seconds could be modified
+	 * again without its mtime changing, so we do not trust it next time.
+	 */
+	int64_t racy = (int64_t)time(NULL) - 2;
+
+	GString *buf = g_string_new(NULL);
+	g_string_append_len(buf, CACHE_MAGIC, 8);
+	put_u32(buf, CACHE_VERSION);
+	put_str(buf, cache->lang);
+	put_u32(buf, cache->fields);
+	put_u32(buf, dirs->len);
+	for (guint i = 0; i < dirs->len; i++) {
+		struct cache_dir *dir = g_ptr_array_index(dirs, i);
+		bool is_racy = dir->mtime >= racy;
+		put_str(buf, dir->path);
+		put_i64(buf, is_racy ? -1 : dir->mtime);
+		put_i64(buf, is_racy ? -1 : dir->mtime_nsec);
+		put_u32(buf, dir->records->len);
+		for (guint j = 0; j < dir->records->len; j++) {
+			struct record *rec = &g_array_index(dir->records,
+				struct record, j);
+			uint8_t type = rec->type;
+			if (type != CACHE_ENTRY_DIR && rec->mtime >= racy) {
+				type = CACHE_ENTRY_UNPARSED;
+			}
+			g_string_append_len(buf, (char *)&type, sizeof(type));
+			put_str(buf, rec->name);
+			if (type == CACHE_ENTRY_DIR) {
+				continue;
+			}
+			put_i64(buf, rec->ino);
+			put_i64(buf, rec->size);
+			put_i64(buf, rec->mtime);
+			put_i64(buf, rec->mtime_nsec);
+			if (type == CACHE_ENTRY_APP) {
+				write_app(buf, rec->app);
+			}
+		}
+	}
+
+	char *filename = cache_filename();
+	char *dirname = g_path_get_dirname(filename);
+	GError *err = NULL;
+	if (g_mkdir_with_parents(dirname, 0700) == -1) {
+		fprintf(stderr, "warn: cannot create directory '%s'\n", dirname);
+	} else if (!g_file_set_contents(filename, buf->str, buf->len, &err)) {
+		fprintf(stderr, "warn: cannot write cache: %s\n", err->message);
+		g_error_free(err);
+	}
+	g_free(dirname);
+	g_free(filename);
+	g_string_free(buf, TRUE);
+}
+
+static void
+cache_dir_free(struct cache_dir *dir)
+{
+	for (guint i = 0; i < dir->records->len; i++) {
+		g_free(g_array_index(dir->records, struct record, i).name);
+	}
+	g_array_free(dir->records, TRUE);
+	g_free(dir->path);
+	g_free(dir);
+}
+
+void
+desktop_cache_close(struct desktop_cache *cache)
+{
+	/* Directories which have disappeared also make the cache stale */
+	if (cache->dirs->len != g_hash_table_size(cache->cached_dirs)) {
+		cache->dirty = true;
+	}
+	if (cache->dirty) {
+		write_cache(cache);
+	}
+
+	g_ptr_array_set_free_func(cache->dirs, (GDestroyNotify)cache_dir_free);
+	g_ptr_array_free(cache->dirs, TRUE);
+	g_hash_table_destroy(cache->cached_dirs);
+	if (cache->map) {
+		munmap(cache->map, cache->map_size);
+	}
+	g_free(cache->lang);
+	g_free(cache);
+}
+
+struct cache_dir *
+desktop_cache_dir_begin(struct desktop_cache *cache, const char *path,
+		struct stat *sb)
+{
+	struct cache_dir *dir = calloc(1, sizeof(*dir));
+	dir->cache = cache;
+	dir->path = g_strdup(path);
+	dir->mtime = sb->st_mtim.tv_sec;
+	dir->mtime_nsec = sb->st_mtim.tv_nsec;
+	dir->cached = g_hash_table_lookup(cache->cached_dirs, path);
+	dir->records = g_array_new(FALSE, FALSE, sizeof(struct record));
+	g_ptr_array_add(cache->dirs, dir);
+	return dir;
+}
+
+const char **
+desktop_cache_dir_names(struct cache_dir *dir, const uint8_t **types)
+{
+	if (!dir->cached || dir->cached->mtime != dir->mtime
+			|| dir->cached->mtime_nsec != dir->mtime_nsec) {
+		dir->cache->dirty = true;
+		return NULL;
+	}
+	*types = dir->cached->types;
+	return dir->cached->names;
+}
+
+static void
+read_app(struct desktop_cache *cache, const char *p, const char *filename,
+		struct app *app)
+{
+	struct reader r = { .p = p, .end = cache->map + cache->map_size };
+
+	app->name = (char *)get_str(&r);
+	app->name_localized = (char *)get_str(&r);
+	app->name_translations = (char *)get_str(&r);
+	app->generic_name = (char *)get_str(&r);
+	app->generic_name_localized = (char *)get_str(&r);
+	app->exec = (char *)get_str(&r);
+	app->tryexec = (char *)get_str(&r);
+	app->working_dir = (char *)get_str(&r);
+	app->icon = (char *)get_str(&r);
+	app->categories = (char *)get_str(&r);
+	uint8_t flags;
+	get(&r, &flags, sizeof(flags));
+	app->nodisplay = flags & APP_FLAG_NODISPLAY;
+	app->terminal = flags & APP_FLAG_TERMINAL;
+	if (cache->fields & APP_FIELD_FILENAME) {
+		app->filename = (char *)filename;
+	}
+}
+
+enum cache_entry_type
+desktop_cache_dir_lookup(struct cache_dir *dir, const char *name,
+		struct stat *sb, struct app *app)
+{
+	struct cached_entry *entry = dir->cached ?
+		g_hash_table_lookup(dir->cached->entries, name) : NULL;
+	if (!entry || entry->type == CACHE_ENTRY_DIR
+			|| entry->type == CACHE_ENTRY_UNPARSED
+			|| entry->ino != (uint64_t)sb->st_ino
+			|| entry->size != sb->st_size
+			|| entry->mtime != sb->st_mtim.tv_sec
+			|| entry->mtime_nsec != sb->st_mtim.tv_nsec) {
+		dir->cache->dirty = true;
+		return CACHE_ENTRY_UNPARSED;
+	}
+	if (entry->type == CACHE_ENTRY_APP) {
+		read_app(dir->cache, entry->app, entry->name, app);
+	}
+	return entry->type;
+}
+
+unsigned int
+desktop_cache_dir_add(struct cache_dir *dir, const char *name,
+		enum cache_entry_type type, struct stat *sb, struct app *app)
+{
+	struct record rec = {
+		.type = type,
+		.name = g_strdup(name),
+		.app = app,
+	};
+	if (type != CACHE_ENTRY_DIR) {
+		rec.ino = sb->st_ino;
+		rec.size = sb->st_size;
+		rec.mtime = sb->st_mtim.tv_sec;
+		rec.mtime_nsec = sb->st_mtim.tv_nsec;
+	}
+	g_array_append_val(dir->records, rec);
+	return dir->records->len - 1;
+}
+
+void
+desktop_cache_dir_update(struct cache_dir *dir, unsigned int index,
+		enum cache_entry_type type, struct app *app)
+{
+	struct record *rec = &g_array_index(dir->records, struct record, index);
+	rec->type = type;
+	rec->app = app;
+}
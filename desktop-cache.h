@@ -0,0 +1,73 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef DESKTOP_CACHE_H
+#define DESKTOP_CACHE_H
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+struct app;
+struct cache_dir;
+struct desktop_cache;
+
+enum cache_entry_type {
+	CACHE_ENTRY_DIR = 0,
+	CACHE_ENTRY_APP,
+	CACHE_ENTRY_INVALID,
+	CACHE_ENTRY_UNPARSED,
+};
+
+/*
+ * desktop_cache_open - map the cache written by a previous run
+ * The cache is discarded if it was written with a different $LANG because
+ * localized names are resolved at parse time, or without any of the enum
+ * app_field @fields.
+ */
+struct desktop_cache *desktop_cache_open(const char *lang,
+	unsigned int fields);
+
+/*
+ * desktop_cache_fields - the fields to fill in, which are those asked for
+ * and any others that the cache has
+ */
+unsigned int desktop_cache_fields(struct desktop_cache *cache);
+
+/*
+ * desktop_cache_close - write the entries recorded during this run and free
+ * @cache
+ */
+void desktop_cache_close(struct desktop_cache *cache);
+
+/* desktop_cache_dir_begin - start recording directory @path */
+struct cache_dir *desktop_cache_dir_begin(struct desktop_cache *cache,
+	const char *path, struct stat *sb);
+
+/*
+ * desktop_cache_dir_names - return the NULL-terminated list of entries last
+ * seen in @dir if its mtime is unchanged, or NULL if it has to be read.
+ * *@types is set to their enum cache_entry_type values in the same order.
+ */
+const char **desktop_cache_dir_names(struct cache_dir *dir,
+	const uint8_t **types);
+
+/*
+ * desktop_cache_dir_lookup - find a file which has not changed since the
+ * cache was written. For CACHE_ENTRY_APP, @app is filled in with strings
+ * which are valid until desktop_cache_close(). CACHE_ENTRY_UNPARSED means
+ * that the file has to be parsed.
+ */
+enum cache_entry_type desktop_cache_dir_lookup(struct cache_dir *dir,
+	const char *name, struct stat *sb, struct app *app);
+
+/*
+ * desktop_cache_dir_add - record an entry of @dir for the next cache
+ * Returns the index of the entry within @dir. @sb may be NULL for a
+ * CACHE_ENTRY_DIR.
+ */
+unsigned int desktop_cache_dir_add(struct cache_dir *dir, const char *name,
+	enum cache_entry_type type, struct stat *sb, struct app *app);
+
+/* desktop_cache_dir_update - set the outcome of parsing a recorded entry */
+void desktop_cache_dir_update(struct cache_dir *dir, unsigned int index,
+	enum cache_entry_type type, struct app *app);
+
+#endif /* DESKTOP_CACHE_H */
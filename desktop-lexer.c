@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Split the [Desktop Entry] group of a .desktop file into keys and values
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <ctype.h>
+#include <glib.h>
+#include <string.h>
+#include "desktop-lexer.h"
+
+#define DESKTOP_ENTRY_HEADER "[Desktop Entry]"
+
+void
+desktop_lexer_init(struct desktop_lexer *lexer, char *buf, size_t len)
+{
+	lexer->p = buf;
+	lexer->end = buf + len;
+	lexer->in_desktop_entry = false;
+}
+
+static void
+strip(char **s, size_t *len)
+{
+	while (*len && isspace((unsigned char)**s)) {
+		(*s)++;
+		(*len)--;
+	}
+	while (*len && isspace((unsigned char)(*s)[*len - 1])) {
+		(*len)--;
+	}
+	(*s)[*len] = '\0';
+}
+
+enum desktop_lexer_status
+desktop_lexer_next(struct desktop_lexer *lexer, struct desktop_entry_line *line)
+{
+	while (lexer->p < lexer->end) {
+		char *start = lexer->p;
+		char *eol = memchr(start, '\n', lexer->end - start);
+		if (!eol) {
+			eol = lexer->end;
+		}
+		lexer->p = eol < lexer->end ? eol + 1 : eol;
+		size_t len = eol - start;
+
+		/*
+		 * .desktop files should be utf-8 compatible, but there are bad
+		 * applications which don't comply so we need to handle
+		 * exceptions.
+		 */
+		if (!g_utf8_validate(start, len, NULL)) {
+			return DESKTOP_LEXER_INVALID_UTF8;
+		}
+
+		/* We only read the [Desktop Entry] group of a .desktop file */
+		if (start[0] == '[') {
+			if (lexer->in_desktop_entry) {
+				return DESKTOP_LEXER_END;
+			}
+			lexer->in_desktop_entry = len >= strlen(DESKTOP_ENTRY_HEADER)
+				&& !strncmp(start, DESKTOP_ENTRY_HEADER,
+					strlen(DESKTOP_ENTRY_HEADER));
+			continue;
+		}
+		if (!lexer->in_desktop_entry) {
+			continue;
+		}
+
+		char *equals = memchr(start, '=', len);
+		if (!equals) {
+			continue;
+		}
+		line->key = start;
+		line->key_len = equals - start;
+		line->value = equals + 1;
+		line->value_len = eol - line->value;
+		strip(&line->key, &line->key_len);
+		strip(&line->value, &line->value_len);
+		return DESKTOP_LEXER_ENTRY;
+	}
+	return DESKTOP_LEXER_END;
+}
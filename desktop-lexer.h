@@ -0,0 +1,42 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef DESKTOP_LEXER_H
+#define DESKTOP_LEXER_H
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * The lexer walks a buffer holding a whole .desktop file and splits the
+ * [Desktop Entry] group into keys and values in place. Whitespace around
+ * keys and values is stripped and both are NUL-terminated within the buffer,
+ * so nothing is copied or allocated.
+ */
+struct desktop_lexer {
+	char *p;
+	char *end;
+	bool in_desktop_entry;
+};
+
+enum desktop_lexer_status {
+	DESKTOP_LEXER_ENTRY,
+	DESKTOP_LEXER_END,
+	DESKTOP_LEXER_INVALID_UTF8,
+};
+
+struct desktop_entry_line {
+	char *key;
+	size_t key_len;
+	char *value;
+	size_t value_len;
+};
+
+/* desktop_lexer_init - @buf must have room for a NUL at @buf[@len] */
+void desktop_lexer_init(struct desktop_lexer *lexer, char *buf, size_t len);
+
+/*
+ * desktop_lexer_next - get the next key=value line of the [Desktop Entry]
+ * group. Returns DESKTOP_LEXER_END at the end of the group.
+ */
+enum desktop_lexer_status desktop_lexer_next(struct desktop_lexer *lexer,
+	struct desktop_entry_line *line);
+
+#endif /* DESKTOP_LEXER_H */
@@ -7,6 +7,7 @@
 #define _DEFAULT_SOURCE
 #include <assert.h>
 #include <ctype.h>
+#include <errno.h>
 #include <glib.h>
 #include <fcntl.h>
 #include <stdio.h>
@@ -17,17 +18,58 @@
 #include <dirent.h>
 #include <stdbool.h>
 #include <unistd.h>
+#ifdef HAVE_GETDENTS64
+#include <sys/syscall.h>
+#endif
+#include "arena.h"
+#include "category.h"
+#include "collate.h"
 #include "desktop.h"
+#include "desktop-cache.h"
+#include "desktop-lexer.h"
 #include "ignore.h"
+#include "path-index.h"
+#include "stats.h"
+#include "trace.h"
+#include "uring-reader.h"
+
+/* d_type is not in POSIX, so may have to be found with stat */
+#ifdef DT_UNKNOWN
+#define DIRENT_TYPE(entry) ((entry)->d_type)
+#else
+#define DT_UNKNOWN 0
+#define DT_DIR 4
+#define DT_REG 8
+#define DT_LNK 10
+#define DIRENT_TYPE(entry) DT_UNKNOWN
+#endif
+
+/* The language which names are localized for */
+struct i18n {
+	char ll[24];
+	char llcc[24];
+	size_t ll_len, llcc_len;
+};
 
-static GList *apps;
-
-static char ll[24] = { 0 };
-static char llcc[24] = { 0 };
-static char name_ll[64] = { 0 };
-static char name_llcc[64] = { 0 };
-static char generic_name_ll[64] = { 0 };
-static char generic_name_llcc[64] = { 0 };
+/* The state of one desktop_entries_create() */
+struct scan {
+	const struct desktop_options *options;
+	/* The fields asked for plus any which the parse cache has */
+	unsigned int fields;
+	struct i18n i18n;
+	struct arena *arena;
+	GMutex arena_lock;
+	struct desktop_cache *cache;
+	GPtrArray *scanned_dirs;
+	GPtrArray *scanned_files;
+	GPtrArray *candidates;
+	GHashTable *desktop_file_ids;
+	GThreadPool *pool;
+	struct uring_reader *reader;
+	/* Candidates for the uring reader, read at the end of each directory */
+	GPtrArray *pending;
+	GList *apps;
+};
 
  /*
   * This snippet borrowed from qemu
@@ -53,133 +95,176 @@ pstrcpy(char *buf, int buf_size, const char *str)
 	*q = '\0';
 }
 
+/*
+ * Parse a $LANG value of the form ll_CC.UTF8 where
+ *  - ‘ll’ is an ISO 639 two-letter language code (lowercase)
+ *  - ‘CC’ is an ISO 3166 two-letter country code (uppercase)
+ */
 static void
-i18n_init(void)
+split_lang(const char *lang, char lang_llcc[24], char lang_ll[24])
 {
-	static bool has_been_initialized;
-
-	if (has_been_initialized) {
-		return;
-	}
-	has_been_initialized = true;
-
-	/*
-	 * Read $LANG and parse ll_CC.UTF8 format where
-	 *  - ‘ll’ is an ISO 639 two-letter language code (lowercase)
-	 *  - ‘CC’ is an ISO 3166 two-letter country code (uppercase)
-	 */
-	char *p = getenv("LANG");
-	if (!p) {
-		fprintf(stderr, "$LANG not set");
-		return;
-	}
-
 	/* ll_CC */
-	pstrcpy(llcc, sizeof(llcc), p);
-	p = strrchr(llcc, '.');
+	pstrcpy(lang_llcc, 24, lang);
+	char *p = strrchr(lang_llcc, '.');
 	if (p) {
 		*p = '\0';
 	}
 
 	/* ll */
-	pstrcpy(ll, sizeof(ll), llcc);
-	p = strrchr(ll, '_');
+	pstrcpy(lang_ll, 24, lang_llcc);
+	p = strrchr(lang_ll, '_');
 	if (p) {
 		*p = '\0';
 	}
-
-	snprintf(name_ll, sizeof(name_ll), "Name[%s]", ll);
-	snprintf(name_llcc, sizeof(name_llcc), "Name[%s]", llcc);
-	snprintf(generic_name_ll, sizeof(generic_name_ll),
-		"GenericName[%s]", ll);
-	snprintf(generic_name_llcc, sizeof(generic_name_llcc),
-		"GenericName[%s]", llcc);
 }
 
-char *name_ll_get(void) { return name_ll; }
-char *name_llcc_get(void) { return name_llcc; }
-
 static void
-parse_line(char *line, struct app *app, int *is_desktop_entry)
+i18n_init(struct i18n *i18n, const char *lang)
 {
-	/* We only read the [Desktop Entry] section of a .desktop file */
-	if (line[0] == '[') {
-		if (!strncmp(line, "[Desktop Entry]", 15)) {
-			*is_desktop_entry = 1;
-		} else {
-			*is_desktop_entry = 0;
-		}
+	uint64_t start = stats_begin();
+	memset(i18n, 0, sizeof(*i18n));
+	if (!lang) {
+		lang = getenv("LANG");
 	}
-	if (!*is_desktop_entry) {
-		return;
+	if (lang) {
+		split_lang(lang, i18n->llcc, i18n->ll);
+		i18n->ll_len = strlen(i18n->ll);
+		i18n->llcc_len = strlen(i18n->llcc);
 	}
+	stats_end(STATS_I18N_INIT, start);
+}
 
-	char *key, *value;
-	gchar **argv = g_strsplit(line, "=", 2);
-	if (g_strv_length(argv) != 2) {
-		g_strfreev(argv);
+void
+lang_name_keys(const char *lang, char name_ll[64], char name_llcc[64])
+{
+	struct i18n i18n;
+	i18n_init(&i18n, lang);
+	snprintf(name_ll, 64, "Name[%s]", i18n.ll);
+	snprintf(name_llcc, 64, "Name[%s]", i18n.llcc);
+}
+
+/*
+ * Most lines are translations, so those in other languages are rejected by
+ * their [locale] suffix alone. A value for $ll_CC beats one for $ll.
+ * Translations of Name= are also collected in @translations if it is not
+ * NULL.
+ */
+static void
+parse_localized_line(struct scan *scan, struct desktop_entry_line *line,
+		struct app *app, GString *translations)
+{
+	const char *ll = scan->i18n.ll, *llcc = scan->i18n.llcc;
+	size_t ll_len = scan->i18n.ll_len, llcc_len = scan->i18n.llcc_len;
+	char *key = line->key, *value = line->value;
+	char *bracket = memchr(key, '[', line->key_len);
+	if (!bracket) {
 		return;
 	}
-	key = g_strstrip(argv[0]);
-	value = g_strstrip(argv[1]);
-
-	if (!strcmp("Name", key)) {
-		app->name = strdup(value);
-	} else if (!strcmp("GenericName", key)) {
-		app->generic_name = strdup(value);
-	} else if (!strcmp("Exec", key)) {
-		app->exec = strdup(value);
-	} else if (!strcmp("TryExec", key)) {
-		app->tryexec = strdup(value);
-	} else if (!strcmp("Path", key)) {
-		app->working_dir = strdup(value);
-	} else if (!strcmp("Icon", key)) {
-		app->icon = strdup(value);
-	} else if (!strcmp("Categories", key)) {
-		app->categories = strdup(value);
-	} else if (!strcmp("NoDisplay", key)) {
-		if (!strcasecmp(value, "true"))
-			app->nodisplay = true;
-	} else if (!strcmp("Terminal", key)) {
-		if (!strcasecmp(value, "true"))
-			app->terminal = true;
-	}
+	size_t key_len = bracket - key;
+	const char *locale = bracket + 1;
+	size_t locale_len = line->key_len - key_len - 2;
 
-	/* localized name */
-	if (!strcmp(key, name_llcc)) {
-		app->name_localized = strdup(value);
+	if (translations && key_len == strlen("Name")
+			&& !memcmp(key, "Name", key_len)) {
+		g_string_append_len(translations, locale, locale_len);
+		g_string_append_c(translations, '=');
+		g_string_append_len(translations, value, line->value_len);
+		g_string_append_c(translations, '\n');
 	}
-	if (!app->name_localized && !strcmp(key, name_ll)) {
-		app->name_localized = strdup(value);
+
+	bool is_llcc = llcc_len && locale_len == llcc_len
+		&& !memcmp(locale, llcc, llcc_len);
+	bool is_ll = !is_llcc && ll_len && locale_len == ll_len
+		&& !memcmp(locale, ll, ll_len);
+	if (!is_llcc && !is_ll) {
+		return;
 	}
 
-	/* localized generic name */
-	if (!strcmp(key, generic_name_llcc)) {
-		app->generic_name_localized = strdup(value);
+	char **localized;
+	if (key_len == strlen("Name") && !memcmp(key, "Name", key_len)) {
+		localized = &app->name_localized;
+	} else if (key_len == strlen("GenericName")
+			&& (scan->fields & APP_FIELD_GENERIC_NAME)
+			&& !memcmp(key, "GenericName", key_len)) {
+		localized = &app->generic_name_localized;
+	} else {
+		return;
 	}
-	if (!app->generic_name_localized && !strcmp(key, generic_name_ll)) {
-		app->generic_name_localized = strdup(value);
+	if (is_llcc || !*localized) {
+		*localized = value;
 	}
-	g_strfreev(argv);
 }
 
-static bool
-is_duplicate_desktop_file(char *filename)
+/* Keys are told apart by their length and first byte before comparing */
+#define KEY(len, c) ((len) << 8 | (unsigned char)(c))
+
+/*
+ * Values are borrowed from the file buffer until the app is committed. Keys
+ * of fields which have not been asked for are skipped, so that they are
+ * neither copied into the arena nor cached.
+ */
+static void
+parse_line(struct scan *scan, struct desktop_entry_line *line,
+		struct app *app, GString *translations)
 {
-	if (!filename) {
-		return false;
+	char *key = line->key, *value = line->value;
+	if (!line->key_len) {
+		return;
 	}
-	GList *iter;
-	for (iter = apps; iter; iter = iter->next) {
-		struct app *app = (struct app *)iter->data;
-		if (!app->filename) {
-			continue;
+	if (key[line->key_len - 1] == ']') {
+		parse_localized_line(scan, line, app, translations);
+		return;
+	}
+	unsigned int fields = scan->fields;
+
+	switch (KEY(line->key_len, key[0])) {
+	case KEY(4, 'N'):
+		if (!strcmp("Name", key)) {
+			app->name = value;
 		}
-		if (!strcmp(app->filename, filename)) {
-			return true;
+		break;
+	case KEY(11, 'G'):
+		if ((fields & APP_FIELD_GENERIC_NAME)
+				&& !strcmp("GenericName", key)) {
+			app->generic_name = value;
 		}
+		break;
+	case KEY(4, 'E'):
+		if (!strcmp("Exec", key)) {
+			app->exec = value;
+		}
+		break;
+	case KEY(7, 'T'):
+		if (!strcmp("TryExec", key)) {
+			app->tryexec = value;
+		}
+		break;
+	case KEY(4, 'P'):
+		if ((fields & APP_FIELD_WORKING_DIR) && !strcmp("Path", key)) {
+			app->working_dir = value;
+		}
+		break;
+	case KEY(4, 'I'):
+		if ((fields & APP_FIELD_ICON) && !strcmp("Icon", key)) {
+			app->icon = value;
+		}
+		break;
+	case KEY(10, 'C'):
+		if (!strcmp("Categories", key)) {
+			app->categories = value;
+		}
+		break;
+	case KEY(9, 'N'):
+		if (!strcmp("NoDisplay", key) && !strcasecmp(value, "true")) {
+			app->nodisplay = true;
+		}
+		break;
+	case KEY(8, 'T'):
+		if (!strcmp("Terminal", key) && !strcasecmp(value, "true")) {
+			app->terminal = true;
+		}
+		break;
 	}
-	return false;
 }
 
 static void
@@ -235,183 +320,533 @@ strip_exec_field_codes(char **exec)
 	rtrim(exec);
 }
 
-static bool
-isprog(const char *prog)
-{
-	char *s = g_find_program_in_path(prog);
-	if (!s) {
-		return false;
-	}
-	g_free(s);
-	return true;
-}
-
-static void
-destroy_app(struct app *app)
+/*
+ * Copy an app whose strings are borrowed from a file buffer or from the
+ * cache into the arena and resolve its categories and sort key. Worker
+ * threads commit apps concurrently.
+ */
+static struct app *
+commit_app(struct scan *scan, struct app *draft)
 {
-	g_free(app->name);
-	g_free(app->name_localized);
-	g_free(app->generic_name);
-	g_free(app->generic_name_localized);
-	g_free(app->exec);
-	g_free(app->tryexec);
-	g_free(app->working_dir);
-	g_free(app->icon);
-	g_free(app->categories);
-	g_free(app->filename);
-	g_free(app);
+	struct arena *arena = scan->arena;
+	draft->category_set = category_set_lookup(draft->categories);
+	char *sort_key = collate_key_create(draft->name_localized ?
+		draft->name_localized : draft->name);
+
+	g_mutex_lock(&scan->arena_lock);
+	struct app *app = arena_alloc(arena, sizeof(*app));
+	*app = *draft;
+	app->name = arena_strdup(arena, draft->name);
+	app->name_localized = arena_strdup(arena, draft->name_localized);
+	app->name_translations = arena_strdup(arena, draft->name_translations);
+	app->generic_name = arena_strdup(arena, draft->generic_name);
+	app->generic_name_localized =
+		arena_strdup(arena, draft->generic_name_localized);
+	app->exec = arena_strdup(arena, draft->exec);
+	app->tryexec = arena_strdup(arena, draft->tryexec);
+	app->working_dir = arena_strdup(arena, draft->working_dir);
+	app->icon = arena_strdup(arena, draft->icon);
+	app->categories = arena_strdup(arena, draft->categories);
+	app->filename = arena_strdup(arena, draft->filename);
+	app->sort_key = arena_strdup(arena, sort_key);
+	g_mutex_unlock(&scan->arena_lock);
+	g_free(sort_key);
+	return app;
 }
 
 static struct app *
-add_app(FILE *fp, char *filename)
+add_app(struct scan *scan, char *buf, size_t len, const char *filename)
 {
-	char line[4096], *p;
-	int is_desktop_entry;
+	struct desktop_lexer lexer;
+	struct desktop_entry_line line;
+	enum desktop_lexer_status status;
+
+	struct app app = { 0 }, *committed = NULL;
+	uint64_t nr_lines = 0;
+	GString *translations = scan->fields & APP_FIELD_NAME_TRANSLATIONS ?
+		g_string_new(NULL) : NULL;
+	desktop_lexer_init(&lexer, buf, len);
+	while ((status = desktop_lexer_next(&lexer, &line)) == DESKTOP_LEXER_ENTRY) {
+		parse_line(scan, &line, &app, translations);
+		nr_lines++;
+	}
+	stats_add(STATS_LINES_PARSED, nr_lines);
+	if (status == DESKTOP_LEXER_INVALID_UTF8) {
+		fprintf(stderr, "warn: file '%s' not utf-8 compatible", filename);
+		goto out;
+	}
+
+	/*
+	 * Bail out if the .desktop file does not contain a [Desktop Entry] or
+	 * Name= field.
+	 */
+	if (!app.name) {
+		fprintf(stderr, "warn: file '%s' contains no valid desktop entry\n", filename);
+		goto out;
+	}
 
-	if (should_ignore(filename)) {
-		return NULL;
+	if (scan->fields & APP_FIELD_FILENAME) {
+		app.filename = (char *)filename;
+	}
+	if (translations && translations->len) {
+		app.name_translations = translations->str;
 	}
 
-	struct app *app = calloc(1, sizeof(struct app));
-	is_desktop_entry = 0;
-	while (fgets(line, sizeof(line), fp)) {
-		if (line[0] == '\0') {
-			continue;
-		}
-		p = strrchr(line, '\n');
-		if (!p) {
+	/* post-processing */
+	if (app.exec) {
+		strip_exec_field_codes(&app.exec);
+	}
+
+	committed = commit_app(scan, &app);
+out:
+	if (translations) {
+		g_string_free(translations, TRUE);
+	}
+	return committed;
+}
+
+/* Read the whole file in one go, leaving room for a NUL terminator */
+static char *
+read_file(int fd, size_t size_hint, size_t *len)
+{
+	size_t size = size_hint + 1;
+	char *buf = g_malloc(size);
+	*len = 0;
+	for (;;) {
+		ssize_t n = read(fd, buf + *len, size - *len - 1);
+		if (n == -1 && errno == EINTR) {
 			continue;
 		}
-		*p = '\0';
-
-		/*
-		 * .desktop files should be utf-8 compatible, but there are bad
-		 * applications which don't comply so we need to handle
-		 * exceptions.
-		 */
-		if (!g_utf8_validate(line, p - &line[0], NULL)) {
-			fprintf(stderr, "warn: file '%s' not utf-8 compatible",
-				filename);
-			/* free current app */
+		if (n == -1) {
+			g_free(buf);
 			return NULL;
 		}
-		parse_line(line, app, &is_desktop_entry);
+		if (n == 0) {
+			break;
+		}
+		*len += n;
+		if (*len == size - 1) {
+			/* The file has grown since we stat'ed it */
+			size *= 2;
+			buf = g_realloc(buf, size);
+		}
 	}
+	buf[*len] = '\0';
+	return buf;
+}
 
-	/*
-	 * Bail out if the .desktop file does not contain a [Desktop Entry] or
-	 * Name= field.
-	 */
-	if (!app->name) {
-		fprintf(stderr, "warn: file '%s' contains no valid desktop entry\n", filename);
-		destroy_app(app);
-		return NULL;
+/*
+ * A .desktop file found by the scanner. Candidates are parsed by a pool of
+ * worker threads and then merged into the list of apps in scan order so that
+ * the result does not depend on the number of threads.
+ */
+struct candidate {
+	struct scan *scan;
+	char *path;
+	char *filename;
+	struct stat sb;
+	struct cache_dir *cache_dir;
+	unsigned int cache_index;
+	enum cache_entry_type type;
+	struct app *app;
+	/* The contents if they were read ahead by the uring reader */
+	char *buf;
+	size_t len;
+};
+
+/* Parse and free @buf */
+static enum cache_entry_type
+parse_buffer(struct scan *scan, char *buf, size_t len, const char *filename,
+		struct app **app)
+{
+	stats_add(STATS_BYTES_READ, len);
+	stats_add(STATS_FILES_PARSED, 1);
+
+	uint64_t start = stats_begin();
+	*app = add_app(scan, buf, len, filename);
+	stats_end(STATS_PARSE, start);
+	g_free(buf);
+	return *app ? CACHE_ENTRY_APP : CACHE_ENTRY_INVALID;
+}
+
+static enum cache_entry_type
+parse_file(struct scan *scan, const char *path, const char *filename,
+		size_t size_hint, struct app **app)
+{
+	uint64_t start = stats_begin();
+	int fd = open(path, O_RDONLY);
+	if (fd == -1) {
+		fprintf(stderr, "warn: could not open file %s", filename);
+		return CACHE_ENTRY_UNPARSED;
+	}
+	size_t len;
+	char *buf = read_file(fd, size_hint, &len);
+	close(fd);
+	stats_end(STATS_READ, start);
+	if (!buf) {
+		return CACHE_ENTRY_UNPARSED;
 	}
+	return parse_buffer(scan, buf, len, filename, app);
+}
 
-	app->filename = strdup(filename);
+static void
+parse_candidate(gpointer data, gpointer user_data)
+{
+	(void)user_data;
+	struct candidate *candidate = data;
+	uint64_t start = trace_begin();
+	if (candidate->buf) {
+		candidate->type = parse_buffer(candidate->scan, candidate->buf,
+			candidate->len, candidate->filename, &candidate->app);
+		candidate->buf = NULL;
+	} else {
+		candidate->type = parse_file(candidate->scan, candidate->path,
+			candidate->filename, candidate->sb.st_size,
+			&candidate->app);
+	}
+	trace_end("parse", candidate->path, start);
+}
 
-	/* post-processing */
-	if (app->exec) {
-		strip_exec_field_codes(&app->exec);
+static void
+dispatch_candidate(struct candidate *candidate)
+{
+	if (candidate->scan->pool) {
+		g_thread_pool_push(candidate->scan->pool, candidate, NULL);
+	} else {
+		parse_candidate(candidate, NULL);
 	}
-	if (app->tryexec && !isprog(app->tryexec)) {
-		app->tryexec_not_in_path = true;
+}
+
+/* Files which could not be read ahead are read again by parse_file() */
+static void
+read_done(struct uring_read *read)
+{
+	struct candidate *candidate = read->data;
+	candidate->buf = read->buf;
+	candidate->len = read->len;
+	dispatch_candidate(candidate);
+}
+
+static void
+read_pending(struct scan *scan, const char *path)
+{
+	GPtrArray *pending = scan->pending;
+	if (!pending->len) {
+		return;
 	}
+	uint64_t start = trace_begin();
+	struct uring_read *reads = g_new0(struct uring_read, pending->len);
+	for (guint i = 0; i < pending->len; i++) {
+		struct candidate *candidate = g_ptr_array_index(pending, i);
+		reads[i].path = candidate->path;
+		reads[i].ino = candidate->sb.st_ino;
+		reads[i].size = candidate->sb.st_size;
+		reads[i].data = candidate;
+	}
+	uring_reader_run(scan->reader, reads, pending->len, read_done);
+	g_free(reads);
+	g_ptr_array_set_size(pending, 0);
+	trace_end("read", path, start);
+}
 
-	return app;
+static void
+free_candidate(struct candidate *candidate)
+{
+	g_free(candidate->path);
+	g_free(candidate);
 }
 
+/* Returns true if the outcome of parsing the candidate is cached */
+static bool
+lookup_candidate(struct candidate *candidate)
+{
+	struct app draft = { 0 };
+	candidate->type = desktop_cache_dir_lookup(candidate->cache_dir,
+		candidate->filename, &candidate->sb, &draft);
+	if (candidate->type == CACHE_ENTRY_APP) {
+		candidate->app = commit_app(candidate->scan, &draft);
+	}
+	if (candidate->type == CACHE_ENTRY_UNPARSED) {
+		return false;
+	}
+	stats_add(STATS_FILES_CACHED, 1);
+	return true;
+}
+
+/* @sb is NULL for a file which is missing, such as a dangling symlink */
 static void
-process_file(char *filename, int dirfd)
+add_scanned_file(struct scan *scan, const char *path, const struct stat *sb)
+{
+	size_t len = strlen(path);
+	struct scanned_file *file = g_malloc0(sizeof(*file) + len + 1);
+	file->is_missing = !sb;
+	if (sb) {
+		file->ino = sb->st_ino;
+		file->size = sb->st_size;
+		file->mtime = sb->st_mtim.tv_sec;
+		file->mtime_nsec = sb->st_mtim.tv_nsec;
+	}
+	memcpy(file->path, path, len + 1);
+	g_ptr_array_add(scan->scanned_files, file);
+}
+
+/*
+ * The desktop file ID is the path relative to the applications directory
+ * with '/' replaced by '-', so @id_prefix is "" at the top level and, for
+ * example, "kde-" in a kde/ subdirectory.
+ */
+static void
+process_file(struct scan *scan, char *filename, int dirfd, const char *path,
+		const char *id_prefix, struct cache_dir *cache_dir)
 {
 	if (!g_str_has_suffix(filename, ".desktop")) {
 		return;
 	}
-	int fd = openat(dirfd, filename, O_RDONLY);
-	if (fd == -1) {
-		fprintf(stderr, "warn: could not open file %s", filename);
+	stats_add(STATS_FILES_SEEN, 1);
+
+	/*
+	 * Files are shadowed by those with the same desktop file ID in higher
+	 * precedence directories, so we do not even open them.
+	 */
+	char *id = g_strconcat(id_prefix, filename, NULL);
+	bool is_ignored = scan->options->ignore
+		&& should_ignore(scan->options->ignore, filename);
+	bool is_duplicate = !is_ignored
+		&& g_hash_table_contains(scan->desktop_file_ids, id);
+	struct stat sb = { 0 };
+	if (is_ignored || is_duplicate) {
+		stats_add(is_ignored ? STATS_FILES_IGNORED : STATS_FILES_DUPLICATE, 1);
+		desktop_cache_dir_add(cache_dir, filename, CACHE_ENTRY_UNPARSED,
+			&sb, NULL);
+		g_free(id);
 		return;
 	}
-	if (is_duplicate_desktop_file(filename)) {
+
+	/*
+	 * Cache entries of symlinks are keyed on their target. Only regular
+	 * files take the desktop file ID, so a dangling symlink does not
+	 * shadow a valid file further down. The others are still listed in
+	 * the cache so that they are looked at again, for example once the
+	 * target of a symlink appears.
+	 */
+	uint64_t start = trace_begin();
+	char *file_path = g_strconcat(path, filename, NULL);
+	bool is_missing = fstatat(dirfd, filename, &sb, 0) == -1;
+	if (is_missing || !S_ISREG(sb.st_mode)) {
+		if (is_missing) {
+			fprintf(stderr, "warn: could not open file %s\n",
+				filename);
+		}
+		add_scanned_file(scan, file_path, is_missing ? NULL : &sb);
+		memset(&sb, 0, sizeof(sb));
+		desktop_cache_dir_add(cache_dir, filename, CACHE_ENTRY_UNPARSED,
+			&sb, NULL);
 		goto out;
 	}
+	g_hash_table_add(scan->desktop_file_ids, id);
+
+	struct candidate *candidate = calloc(1, sizeof(*candidate));
+	candidate->scan = scan;
+	candidate->path = file_path;
+	candidate->filename = candidate->path + strlen(path);
+	candidate->sb = sb;
+	candidate->cache_dir = cache_dir;
+	candidate->cache_index = desktop_cache_dir_add(cache_dir, filename,
+		CACHE_ENTRY_UNPARSED, &sb, NULL);
+	g_ptr_array_add(scan->candidates, candidate);
+
+	if (lookup_candidate(candidate)) {
+		/* cached */
+	} else if (scan->reader) {
+		g_ptr_array_add(scan->pending, candidate);
+	} else {
+		dispatch_candidate(candidate);
+	}
+	trace_end("file", candidate->path, start);
+	return;
+out:
+	trace_end("file", file_path, start);
+	g_free(file_path);
+	g_free(id);
+}
 
-	FILE *fp = fdopen(fd, "r");
-	if (!fp) {
-		goto out;
+static void
+merge_candidates(struct scan *scan)
+{
+	GList *apps = NULL;
+	for (guint i = 0; i < scan->candidates->len; i++) {
+		struct candidate *candidate = g_ptr_array_index(scan->candidates, i);
+		desktop_cache_dir_update(candidate->cache_dir,
+			candidate->cache_index, candidate->type, candidate->app);
+
+		if (candidate->type == CACHE_ENTRY_INVALID) {
+			stats_add(STATS_FILES_INVALID, 1);
+		}
+		struct app *app = candidate->app;
+		if (!app) {
+			continue;
+		}
+
+		/* Parsed apps are cached whatever the ignore file says */
+		if (scan->options->ignore
+				&& should_ignore_app(scan->options->ignore, app)) {
+			stats_add(STATS_FILES_IGNORED, 1);
+			continue;
+		}
+
+		/*
+		 * TryExec depends on $PATH so is never cached. There is no
+		 * need to check apps which are not displayed anyway.
+		 */
+		if (app->tryexec && !app->nodisplay) {
+			uint64_t start = stats_begin();
+			app->tryexec_not_in_path = !path_index_find(
+				scan->options->path_index, app->tryexec);
+			stats_end(STATS_TRYEXEC, start);
+		}
+		apps = g_list_prepend(apps, app);
 	}
-	struct app *app = add_app(fp, filename);
-	if (app) {
-		apps = g_list_append(apps, app);
+	scan->apps = g_list_reverse(apps);
+}
+
+static void traverse_directory(struct scan *scan, int fd, const char *path,
+	const char *id_prefix);
+
+/*
+ * Entries are told apart by d_type where the filesystem provides it, so
+ * that files other than .desktop files cost no system calls at all. Only
+ * the directories and .desktop files are stat'ed.
+ */
+static void
+visit_entry(struct scan *scan, int fd, const char *path, const char *id_prefix,
+		struct cache_dir *cache_dir, char *name, unsigned char type)
+{
+	if (type == DT_UNKNOWN) {
+		struct stat sb;
+		if (fstatat(fd, name, &sb, AT_SYMLINK_NOFOLLOW) == -1) {
+			return;
+		}
+		type = S_ISDIR(sb.st_mode) ? DT_DIR : S_ISREG(sb.st_mode) ? DT_REG
+			: S_ISLNK(sb.st_mode) ? DT_LNK : DT_UNKNOWN;
 	}
-	fclose(fp);
 
-out:
-	close(fd);
+	if (type == DT_DIR) {
+		if (!strcmp(name, ".") || !strcmp(name, "..")) {
+			return;
+		}
+		int child = openat(fd, name, O_RDONLY | O_DIRECTORY);
+		if (child == -1) {
+			return;
+		}
+		desktop_cache_dir_add(cache_dir, name, CACHE_ENTRY_DIR, NULL, NULL);
+		char *child_path = g_strdup_printf("%s%s/", path, name);
+		char *child_id_prefix = g_strdup_printf("%s%s-", id_prefix, name);
+		traverse_directory(scan, child, child_path, child_id_prefix);
+		g_free(child_id_prefix);
+		g_free(child_path);
+	} else if (type == DT_REG || type == DT_LNK) {
+		process_file(scan, name, fd, path, id_prefix, cache_dir);
+	}
 }
 
+#ifdef HAVE_GETDENTS64
+/* The layout of the records returned by the getdents64 system call */
+struct linux_dirent64 {
+	uint64_t d_ino;
+	int64_t d_off;
+	unsigned short d_reclen;
+	unsigned char d_type;
+	char d_name[];
+};
+
+#define DIRENT_BUF_SIZE 32768
+
+/* Read the entries of @fd in large batches and close it */
 static void
-traverse_directory(int fd)
+read_directory(struct scan *scan, int fd, const char *path,
+		const char *id_prefix, struct cache_dir *cache_dir)
+{
+	char *buf = g_malloc(DIRENT_BUF_SIZE);
+	long n;
+	while ((n = syscall(SYS_getdents64, fd, buf, DIRENT_BUF_SIZE)) > 0) {
+		for (long offset = 0; offset < n;) {
+			struct linux_dirent64 *entry = (void *)(buf + offset);
+			visit_entry(scan, fd, path, id_prefix, cache_dir,
+				entry->d_name, entry->d_type);
+			offset += entry->d_reclen;
+		}
+	}
+	g_free(buf);
+	close(fd);
+}
+#else
+static void
+read_directory(struct scan *scan, int fd, const char *path,
+		const char *id_prefix, struct cache_dir *cache_dir)
 {
 	DIR *dp = fdopendir(fd);
 	if (!dp) {
+		close(fd);
 		return;
 	}
-
 	struct dirent *entry;
 	while ((entry = readdir(dp))) {
-		/* We prefer stat over entry->d_type for portability */
-		struct stat sb;
-		if (fstatat(dirfd(dp), entry->d_name, &sb, AT_SYMLINK_NOFOLLOW) == -1) {
-                        continue;
-		}
-
-		if (S_ISDIR(sb.st_mode)) {
-			if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, "..")) {
-				continue;
-			}
-			int child = openat(fd, entry->d_name,  O_RDONLY | O_DIRECTORY);
-			if (child == -1) {
-				continue;
-			}
-			traverse_directory(child);
-		} else if (S_ISREG(sb.st_mode) || S_ISLNK(sb.st_mode)) {
-			process_file(entry->d_name, fd);
-		}
+		visit_entry(scan, fd, path, id_prefix, cache_dir, entry->d_name,
+			DIRENT_TYPE(entry));
 	}
 	closedir(dp);
 }
+#endif
 
-static int
-compare_app_name(const void *a, const void *b)
+static void
+traverse_directory(struct scan *scan, int fd, const char *path,
+		const char *id_prefix)
 {
-	const struct app *aa = (struct app *)a;
-	const struct app *bb = (struct app *)b;
-	const char *aa_name, *bb_name;
+	uint64_t start = trace_begin();
+	struct stat sb;
+	if (fstat(fd, &sb) == -1) {
+		close(fd);
+		return;
+	}
+	struct cache_dir *cache_dir = desktop_cache_dir_begin(scan->cache, path,
+		&sb);
+	g_ptr_array_add(scan->scanned_dirs, g_strdup(path));
+	stats_add(STATS_DIRS_VISITED, 1);
+
+	/* Unchanged directories are listed from the cache */
+	const uint8_t *types;
+	const char **names = desktop_cache_dir_names(cache_dir, &types);
+	if (names) {
+		for (guint i = 0; names[i]; i++) {
+			visit_entry(scan, fd, path, id_prefix, cache_dir,
+				(char *)names[i],
+				types[i] == CACHE_ENTRY_DIR ? DT_DIR : DT_REG);
+		}
+		close(fd);
+	} else {
+		read_directory(scan, fd, path, id_prefix, cache_dir);
+	}
+	if (scan->reader) {
+		read_pending(scan, path);
+	}
+	trace_end("dir", path, start);
+}
 
-	/*
-	 * We use g_utf8_casefold+strcmp instead of merely strcasecmp to
-	 * correctly sort languages other than English.
-	 */
-	aa_name = aa->name_localized ? aa->name_localized : aa->name;
-	bb_name = bb->name_localized ? bb->name_localized : bb->name;
-	aa_name = g_utf8_casefold(aa_name, -1);
-	bb_name = g_utf8_casefold(bb_name, -1);
-	int ret = g_strcmp0(aa_name, bb_name);
-	g_free((void *)aa_name);
-	g_free((void *)bb_name);
-	return ret;
+static const char *
+get_app_sort_key(const void *app)
+{
+	return ((const struct app *)app)->sort_key;
 }
 
 static void
-process_directory(const char *dirname)
+process_directory(struct scan *scan, const char *dirname)
 {
 	assert(dirname);
 	int fd = open(dirname, O_RDONLY | O_DIRECTORY);
 	if (fd == -1) {
 		return;
 	}
-	traverse_directory(fd);
+	traverse_directory(scan, fd, dirname, "");
 }
 
 static struct  {
@@ -427,12 +862,10 @@ static struct  {
 	{ NULL, NULL }
 };
 
-GList *
-desktop_entries_create(void)
+GPtrArray *
+desktop_search_paths_create(void)
 {
-	GString *s = g_string_new(NULL);
-
-	i18n_init();
+	GPtrArray *paths = g_ptr_array_new_with_free_func(g_free);
 
 	for (int i = 0; xdg_data_dirs[i].path; ++i) {
 		if (xdg_data_dirs[i].prefix) {
@@ -447,32 +880,138 @@ desktop_entries_create(void)
 			 */
 			gchar **prefixes = g_strsplit(env, ":", -1);
 			for (gchar **p = prefixes; *p; p++) {
-				g_string_printf(s, "%s%s/applications/", *p,
-					xdg_data_dirs[i].path);
-				process_directory(s->str);
+				g_ptr_array_add(paths, g_strdup_printf(
+					"%s%s/applications/", *p,
+					xdg_data_dirs[i].path));
 			}
 			g_strfreev(prefixes);
 		} else {
-			g_string_printf(s, "%s/applications/", xdg_data_dirs[i].path);
-			process_directory(s->str);
+			g_ptr_array_add(paths, g_strdup_printf("%s/applications/",
+				xdg_data_dirs[i].path));
 		}
 		if (getenv("LABWC_MENU_GENERATOR_DEBUG_FIRST_DIR_ONLY")) {
 			break;
 		}
 	}
-	g_string_free(s, TRUE);
-	apps = g_list_sort(apps, (GCompareFunc)compare_app_name);
+	return paths;
+}
 
-	return apps;
+/* Pick the translation just like parse_localized_line() does */
+static char *
+find_translation(const char *translations, const char *lang_llcc,
+		const char *lang_ll)
+{
+	const char *found = NULL, *found_ll = NULL;
+	size_t llcc_n = strlen(lang_llcc), ll_n = strlen(lang_ll);
+	for (const char *p = translations; p && *p; ) {
+		const char *eol = strchr(p, '\n');
+		const char *eq = memchr(p, '=', eol - p);
+		size_t n = eq - p;
+		if (llcc_n && n == llcc_n && !memcmp(p, lang_llcc, n)) {
+			found = eq + 1;
+		} else if (!found_ll && ll_n && n == ll_n && !memcmp(p, lang_ll, n)) {
+			found_ll = eq + 1;
+		}
+		p = eol + 1;
+	}
+	if (!found) {
+		found = found_ll;
+	}
+	return found ? g_strndup(found, strchr(found, '\n') - found) : NULL;
+}
+
+void
+desktop_entries_localize(GList *apps, struct arena *arena, const char *lang)
+{
+	struct i18n i18n;
+	i18n_init(&i18n, lang);
+
+	uint64_t start = stats_begin();
+	for (GList *iter = apps; iter; iter = iter->next) {
+		struct app *app = iter->data;
+		char *name = find_translation(app->name_translations,
+			i18n.llcc, i18n.ll);
+		char *sort_key = collate_key_create(name ? name : app->name);
+		app->name_localized = arena_strdup(arena, name);
+		app->sort_key = arena_strdup(arena, sort_key);
+		g_free(sort_key);
+		g_free(name);
+	}
+	collate_list_sort(apps, get_app_sort_key);
+	stats_end(STATS_SORT, start);
+}
+
+GList *
+desktop_entries_create(struct arena *arena,
+		const struct desktop_options *options, GPtrArray *scanned_dirs,
+		GPtrArray *scanned_files)
+{
+	struct scan scan = {
+		.options = options,
+		.arena = arena,
+		.scanned_dirs = scanned_dirs,
+		.scanned_files = scanned_files,
+	};
+	g_mutex_init(&scan.arena_lock);
+	i18n_init(&scan.i18n, options->lang);
+	scan.cache = desktop_cache_open(options->lang ? options->lang
+		: getenv("LANG"), options->fields);
+	scan.fields = desktop_cache_fields(scan.cache);
+
+	/*
+	 * The scanner runs in this thread and hands files over to the pool
+	 * as it finds them.
+	 */
+	scan.candidates = g_ptr_array_new_with_free_func(
+		(GDestroyNotify)free_candidate);
+	scan.desktop_file_ids = g_hash_table_new_full(g_str_hash, g_str_equal,
+		g_free, NULL);
+	int jobs = options->jobs > 0 ? options->jobs
+		: (int)g_get_num_processors();
+	if (jobs > 1) {
+		scan.pool = g_thread_pool_new(parse_candidate, NULL, jobs, TRUE,
+			NULL);
+	}
+	if (!getenv("LABWC_MENU_GENERATOR_NO_IO_URING")) {
+		scan.reader = uring_reader_create();
+	}
+	scan.pending = g_ptr_array_new();
+
+	/* Includes waiting for the pool to finish parsing */
+	uint64_t start = stats_begin();
+	GPtrArray *paths = desktop_search_paths_create();
+	for (guint i = 0; i < paths->len; i++) {
+		process_directory(&scan, g_ptr_array_index(paths, i));
+	}
+	g_ptr_array_free(paths, TRUE);
+
+	if (scan.pool) {
+		g_thread_pool_free(scan.pool, FALSE, TRUE);
+	}
+	uring_reader_destroy(scan.reader);
+	g_ptr_array_free(scan.pending, TRUE);
+	stats_end(STATS_TRAVERSE, start);
+
+	path_index_reset(options->path_index, scanned_dirs);
+	merge_candidates(&scan);
+	for (guint i = 0; i < scan.candidates->len; i++) {
+		struct candidate *candidate = g_ptr_array_index(scan.candidates, i);
+		add_scanned_file(&scan, candidate->path, &candidate->sb);
+	}
+	g_hash_table_destroy(scan.desktop_file_ids);
+	g_ptr_array_free(scan.candidates, TRUE);
+
+	desktop_cache_close(scan.cache);
+	g_mutex_clear(&scan.arena_lock);
+	start = stats_begin();
+	collate_list_sort(scan.apps, get_app_sort_key);
+	stats_end(STATS_SORT, start);
+
+	return scan.apps;
 }
 
 void
 desktop_entries_destroy(GList *apps)
 {
-	GList *iter;
-	for (iter = apps; iter; iter = iter->next) {
-		struct app *app = (struct app *)iter->data;
-		destroy_app(app);
-	}
 	g_list_free(apps);
 }
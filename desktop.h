@@ -3,10 +3,31 @@
 #define DESKTOP_H
 
 #include <stdbool.h>
+#include <stdint.h>
+
+struct arena;
+struct ignore;
+struct path_index;
+
+/*
+ * The fields of struct app which are only filled in if asked for. The others
+ * decide whether and where an app is shown, so they are always there.
+ */
+enum app_field {
+	APP_FIELD_FILENAME = 1 << 0,
+	APP_FIELD_ICON = 1 << 1,
+	/* GenericName= and its translation */
+	APP_FIELD_GENERIC_NAME = 1 << 2,
+	APP_FIELD_WORKING_DIR = 1 << 3,
+	/* Name= in every language, for desktop_entries_localize() */
+	APP_FIELD_NAME_TRANSLATIONS = 1 << 4,
+};
 
 struct app {
 	char *name;
 	char *name_localized;
+	/* "ll_CC=value\n" per Name[ll_CC] if translations are kept */
+	char *name_translations;
 	char *generic_name;
 	char *generic_name_localized;
 	char *exec;
@@ -15,18 +36,69 @@ struct app {
 	bool tryexec_not_in_path;
 	char *icon;
 	char *categories;
+	uint64_t category_set;
 	bool nodisplay;
 	char *filename;
 	bool terminal;
-	bool has_been_mapped;
+	char *sort_key;
+};
+
+/* How desktop_entries_create() parses the .desktop files */
+struct desktop_options {
+	/* Threads parsing .desktop files, or 0 for one per online CPU */
+	int jobs;
+	/* The $LANG value to localize names for, or NULL for $LANG */
+	const char *lang;
+	/* The enum app_field bits of the optional fields to fill in */
+	unsigned int fields;
+	/* Files to skip, or NULL */
+	struct ignore *ignore;
+	/* The $PATH index which TryExec= is checked against */
+	struct path_index *path_index;
 };
 
-/* desktop_entries_create - parse system .desktop files */
-GList *desktop_entries_create(void);
+/* A .desktop file as it was when it was looked up or read */
+struct scanned_file {
+	/* The file or the target of the symlink did not exist */
+	bool is_missing;
+	uint64_t ino;
+	int64_t size;
+	int64_t mtime;
+	long mtime_nsec;
+	char path[];
+};
+
+/*
+ * desktop_entries_create - parse system .desktop files
+ * All apps and their strings are allocated from @arena, so they are released
+ * by resetting or destroying the arena after desktop_entries_destroy(). The
+ * directories scanned, including those in $PATH, are added to @scanned_dirs
+ * and the .desktop files which are not shadowed or ignored by name, including
+ * dangling symlinks, are added to @scanned_files as g_free()able struct
+ * scanned_file.
+ */
+GList *desktop_entries_create(struct arena *arena,
+	const struct desktop_options *options, GPtrArray *scanned_dirs,
+	GPtrArray *scanned_files);
 void desktop_entries_destroy(GList *apps);
 
-/* return "Name[$ll]" and "Name[$ll_CC] */
-char *name_ll_get(void);
-char *name_llcc_get(void);
+/*
+ * desktop_entries_localize - resolve the names of @apps for the $LANG value
+ * @lang and sort them again in the current LC_COLLATE order
+ */
+void desktop_entries_localize(GList *apps, struct arena *arena,
+	const char *lang);
+
+/*
+ * desktop_search_paths_create - list the applications directories to scan,
+ * highest precedence first
+ */
+GPtrArray *desktop_search_paths_create(void);
+
+/*
+ * lang_name_keys - return "Name[$ll]" and "Name[$ll_CC]" for the $LANG value
+ * @lang, or for $LANG if NULL
+ */
+void lang_name_keys(const char *lang, char name_ll[64], char name_llcc[64]);
 
 #endif /* DESKTOP_H */
@@ -1,22 +1,151 @@
 // SPDX-License-Identifier: GPL-2.0-only
 /* Copyright (C) Johan Malm 2024 */
 #define _POSIX_C_SOURCE 200809L
+#include <fnmatch.h>
 #include <glib.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include "desktop.h"
 #include "ignore.h"
 
-static GList *ignore_files;
+/*
+ * Most globs only have a '*' at one end or at both, so they are compiled
+ * into a prefix, suffix or substring test and only the rest go through
+ * fnmatch()
+ */
+enum glob_kind {
+	GLOB_EXACT = 0,
+	GLOB_PREFIX,
+	GLOB_SUFFIX,
+	GLOB_INFIX,
+	GLOB_FNMATCH,
+};
 
-void
-ignore_init(const char *filename)
+struct glob {
+	enum glob_kind kind;
+	/* The pattern without the '*' at its ends unless GLOB_FNMATCH */
+	char *s;
+	size_t len;
+};
+
+struct ignore {
+	/* Filenames listed as they are */
+	GHashTable *names;
+	/* Arrays of struct glob */
+	GArray *name_globs;
+	GArray *exec_globs;
+	GArray *category_globs;
+};
+
+static bool
+has_wildcard(const char *s, size_t len)
 {
-	if (!filename || !*filename) {
+	for (size_t i = 0; i < len; i++) {
+		if (s[i] == '*' || s[i] == '?' || s[i] == '[' || s[i] == '\\') {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void
+glob_add(GArray *globs, const char *pattern)
+{
+	size_t len = strlen(pattern);
+	bool leading = len && pattern[0] == '*';
+	bool trailing = len > 1 && pattern[len - 1] == '*';
+	const char *inner = pattern + leading;
+	size_t inner_len = len - leading - trailing;
+
+	struct glob glob = { .kind = GLOB_FNMATCH };
+	if (!has_wildcard(inner, inner_len)) {
+		glob.kind = leading && trailing ? GLOB_INFIX : leading ? GLOB_SUFFIX
+			: trailing ? GLOB_PREFIX : GLOB_EXACT;
+		glob.s = g_strndup(inner, inner_len);
+		glob.len = inner_len;
+	} else {
+		glob.s = g_strdup(pattern);
+		glob.len = len;
+	}
+	g_array_append_val(globs, glob);
+}
+
+static bool
+glob_match(struct glob *glob, const char *s, size_t len)
+{
+	switch (glob->kind) {
+	case GLOB_EXACT:
+		return len == glob->len && !memcmp(s, glob->s, len);
+	case GLOB_PREFIX:
+		return len >= glob->len && !memcmp(s, glob->s, glob->len);
+	case GLOB_SUFFIX:
+		return len >= glob->len
+			&& !memcmp(s + len - glob->len, glob->s, glob->len);
+	case GLOB_INFIX:
+		return g_strstr_len(s, len, glob->s) != NULL;
+	case GLOB_FNMATCH:
+		break;
+	}
+	/* fnmatch() wants a string, and @s may be part of a longer one */
+	char *copy = g_strndup(s, len);
+	bool match = !fnmatch(glob->s, copy, 0);
+	g_free(copy);
+	return match;
+}
+
+static bool
+globs_match(GArray *globs, const char *s, size_t len)
+{
+	for (guint i = 0; i < globs->len; i++) {
+		if (glob_match(&g_array_index(globs, struct glob, i), s, len)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void
+globs_free(GArray *globs)
+{
+	for (guint i = 0; i < globs->len; i++) {
+		g_free(g_array_index(globs, struct glob, i).s);
+	}
+	g_array_free(globs, TRUE);
+}
+
+static void
+add_line(struct ignore *ignore, const char *line)
+{
+	if (!*line || *line == '#') {
 		return;
 	}
+	if (g_str_has_prefix(line, "Exec=")) {
+		glob_add(ignore->exec_globs, line + strlen("Exec="));
+	} else if (g_str_has_prefix(line, "Categories=")) {
+		glob_add(ignore->category_globs, line + strlen("Categories="));
+	} else if (has_wildcard(line, strlen(line))) {
+		glob_add(ignore->name_globs, line);
+	} else {
+		g_hash_table_add(ignore->names, g_strdup(line));
+	}
+}
+
+struct ignore *
+ignore_create(const char *filename)
+{
+	struct ignore *ignore = g_new0(struct ignore, 1);
+	ignore->names = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+		NULL);
+	ignore->name_globs = g_array_new(FALSE, FALSE, sizeof(struct glob));
+	ignore->exec_globs = g_array_new(FALSE, FALSE, sizeof(struct glob));
+	ignore->category_globs = g_array_new(FALSE, FALSE, sizeof(struct glob));
+	if (!filename || !*filename) {
+		return ignore;
+	}
 	FILE *stream = fopen(filename, "r");
 	if (!stream) {
-		return;
+		return ignore;
 	}
 	char *line = NULL;
 	size_t len = 0;
@@ -25,27 +154,50 @@ ignore_init(const char *filename)
 		if (p) {
 			*p = '\0';
 		}
-		ignore_files = g_list_append(ignore_files,
-			g_strdup(g_strstrip(line)));
+		add_line(ignore, g_strstrip(line));
 	}
 	free(line);
 	fclose(stream);
+	return ignore;
 }
 
 void
-ignore_finish(void)
+ignore_destroy(struct ignore *ignore)
 {
-	g_list_free_full(ignore_files, g_free);
+	if (!ignore) {
+		return;
+	}
+	g_hash_table_destroy(ignore->names);
+	globs_free(ignore->name_globs);
+	globs_free(ignore->exec_globs);
+	globs_free(ignore->category_globs);
+	g_free(ignore);
 }
 
 bool
-should_ignore(const char *filename)
+should_ignore(struct ignore *ignore, const char *filename)
 {
-	GList *iter;
-	for (iter = ignore_files; iter; iter = iter->next) {
-		if (!g_strcmp0((char *)iter->data, filename)) {
+	return g_hash_table_contains(ignore->names, filename)
+		|| globs_match(ignore->name_globs, filename, strlen(filename));
+}
+
+bool
+should_ignore_app(struct ignore *ignore, struct app *app)
+{
+	if (app->exec && globs_match(ignore->exec_globs, app->exec,
+			strlen(app->exec))) {
+		return true;
+	}
+	if (!app->categories || !ignore->category_globs->len) {
+		return false;
+	}
+	/* Each category is matched on its own */
+	for (const char *p = app->categories; *p;) {
+		size_t len = strcspn(p, ";");
+		if (len && globs_match(ignore->category_globs, p, len)) {
 			return true;
 		}
+		p += len + (p[len] == ';');
 	}
 	return false;
 }
@@ -3,8 +3,25 @@
 #define IGNORE_H
 #include <stdbool.h>
 
-void ignore_init(const char *filename);
-void ignore_finish(void);
-bool should_ignore(const char *filename);
+struct app;
+struct ignore;
+
+/*
+ * ignore_create - read the list of .desktop files to ignore from @filename.
+ * A missing file, or a NULL or empty @filename, gives an empty list.
+ *
+ * Each line is a filename, a glob such as "org.gtk.*" matched against
+ * filenames, or "Exec=<glob>" or "Categories=<glob>" matched against the
+ * Exec= value or each of the categories of the parsed file. Blank lines and
+ * lines starting with # are skipped.
+ */
+struct ignore *ignore_create(const char *filename);
+void ignore_destroy(struct ignore *ignore);
+
+/* should_ignore - match @filename before the file is even opened */
+bool should_ignore(struct ignore *ignore, const char *filename);
+
+/* should_ignore_app - match the Exec= and Categories= lines */
+bool should_ignore_app(struct ignore *ignore, struct app *app);
 
 #endif /* IGNORE_H */
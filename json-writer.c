@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Escape JSON
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <glib.h>
+#include <string.h>
+#include "json-writer.h"
+
+static bool
+needs_escape(unsigned char c)
+{
+	return c < 0x20 || c == '"' || c == '\\';
+}
+
+/* Append @len bytes of valid UTF-8 at @s, escaping only ASCII */
+static void
+append_escaped(GString *buf, const char *s, size_t len)
+{
+	static const char hex[] = "0123456789abcdef";
+
+	const char *end = s + len;
+	for (;;) {
+		const char *start = s;
+		while (s < end && !needs_escape(*s)) {
+			s++;
+		}
+		g_string_append_len(buf, start, s - start);
+		if (s == end) {
+			return;
+		}
+		switch (*s) {
+		case '"':
+			json_append_literal(buf, "\\\"");
+			break;
+		case '\\':
+			json_append_literal(buf, "\\\\");
+			break;
+		case '\n':
+			json_append_literal(buf, "\\n");
+			break;
+		case '\t':
+			json_append_literal(buf, "\\t");
+			break;
+		default:
+			json_append_literal(buf, "\\u00");
+			g_string_append_c(buf, hex[(unsigned char)*s >> 4]);
+			g_string_append_c(buf, hex[*s & 0xf]);
+			break;
+		}
+		s++;
+	}
+}
+
+/*
+ * JSON has to be UTF-8 but filenames need not be, so invalid sequences are
+ * replaced with U+FFFD
+ */
+static void
+append_quoted(GString *buf, const char *s, size_t len)
+{
+	g_string_append_c(buf, '"');
+	if (g_utf8_validate(s, len, NULL)) {
+		append_escaped(buf, s, len);
+	} else {
+		char *valid = g_utf8_make_valid(s, len);
+		append_escaped(buf, valid, strlen(valid));
+		g_free(valid);
+	}
+	g_string_append_c(buf, '"');
+}
+
+void
+json_append_string(GString *buf, const char *s)
+{
+	if (!s) {
+		json_append_literal(buf, "null");
+		return;
+	}
+	append_quoted(buf, s, strlen(s));
+}
+
+void
+json_append_list(GString *buf, const char *s)
+{
+	g_string_append_c(buf, '[');
+	bool is_first = true;
+	while (s && *s) {
+		const char *end = strchr(s, ';');
+		size_t len = end ? (size_t)(end - s) : strlen(s);
+		if (len) {
+			if (!is_first) {
+				g_string_append_c(buf, ',');
+			}
+			append_quoted(buf, s, len);
+			is_first = false;
+		}
+		s += end ? len + 1 : len;
+	}
+	g_string_append_c(buf, ']');
+}
+
+void
+json_append_bool(GString *buf, bool value)
+{
+	if (value) {
+		json_append_literal(buf, "true");
+	} else {
+		json_append_literal(buf, "false");
+	}
+}
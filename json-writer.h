@@ -0,0 +1,31 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+#include <glib.h>
+#include <stdbool.h>
+
+/*
+ * Like the XML, JSON is appended to the menu in a single pass, with strings
+ * escaped as they are copied.
+ */
+
+/* json_append_literal - append the string literal @s */
+#define json_append_literal(buf, s) \
+	g_string_append_len((buf), "" s, sizeof(s) - 1)
+
+/*
+ * json_append_string - append @s as a quoted string, or null if it is NULL
+ * Sequences which are not valid UTF-8 are replaced with U+FFFD.
+ */
+void json_append_string(GString *buf, const char *s);
+
+/*
+ * json_append_list - append the ;-separated list @s, such as the value of
+ * Categories=, as an array of strings. NULL is an empty array.
+ */
+void json_append_list(GString *buf, const char *s);
+
+/* json_append_bool - append true or false */
+void json_append_bool(GString *buf, bool value);
+
+#endif /* JSON_WRITER_H */
@@ -0,0 +1,48 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_MENU_PRIVATE_H
+#define LABWC_MENU_PRIVATE_H
+#include <glib.h>
+#include <stdbool.h>
+#include "labwc-menu.h"
+
+/*
+ * What labwc-menu-generator needs from a context beyond the public API.
+ * These are not exported from the shared library.
+ */
+
+struct menu_update;
+
+/*
+ * labwc_menu_set_fields - fill in only the enum app_field @fields of the
+ * apps on the next scan, for example those of render_fields(). The default
+ * is the fields of struct labwc_menu_app. labwc_menu_localize() needs
+ * APP_FIELD_NAME_TRANSLATIONS.
+ */
+void labwc_menu_set_fields(struct labwc_menu *menu, unsigned int fields);
+
+/*
+ * labwc_menu_localize - localize the apps and directories for the $LANG
+ * value @lang and sort them in the current LC_COLLATE order
+ */
+void labwc_menu_localize(struct labwc_menu *menu, const char *lang);
+
+/*
+ * labwc_menu_scanned_dirs - the directories read by the last scan, and
+ * those in $PATH once TryExec= or --check-exec has looked a program up
+ */
+GPtrArray *labwc_menu_scanned_dirs(struct labwc_menu *menu);
+
+/*
+ * labwc_menu_scanned_files - the .desktop files of the last scan as struct
+ * scanned_file, with their state when they were read
+ */
+GPtrArray *labwc_menu_scanned_files(struct labwc_menu *menu);
+
+/*
+ * labwc_menu_render_request - append the menu for a daemon @request to
+ * @buf, reusing the unchanged parts of the previous menu if @update is set
+ */
+void labwc_menu_render_request(struct labwc_menu *menu, GString *buf,
+	const char *request, struct menu_update *update);
+
+#endif /* LABWC_MENU_PRIVATE_H */
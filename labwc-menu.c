@@ -0,0 +1,250 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * liblabwc-menu contexts
+ *
+ * A context owns everything that one scan produces: the apps and their
+ * arena, the directories, the $PATH index and the ignore list. Nothing is
+ * shared between contexts apart from the process-wide collation, --stats
+ * counters and trace output.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#include "desktop.h"
+#include "ignore.h"
+#include "labwc-menu-private.h"
+#include "path-index.h"
+#include "render.h"
+#include "stats.h"
+
+/* The shared library exports the public API only */
+#define EXPORT __attribute__((visibility("default")))
+
+struct labwc_menu {
+	struct arena *arena;
+	struct path_index *path_index;
+	struct ignore *ignore;
+	char *ignore_file;
+	struct desktop_options desktop_options;
+	GList *apps;
+	GList *dirs;
+	GPtrArray *scanned_dirs;
+	GPtrArray *scanned_files;
+	/* The views handed out by labwc_menu_dirs() and labwc_menu_dir_apps() */
+	struct labwc_menu_dir *dir_views;
+	size_t nr_dir_views;
+	struct labwc_menu_app *app_views;
+	/* The last menu rendered and the request it was rendered for */
+	GString *rendered;
+	char *rendered_request;
+};
+
+EXPORT struct labwc_menu *
+labwc_menu_create(void)
+{
+	if (!getenv("LANG")) {
+		fprintf(stderr, "$LANG not set");
+	}
+	struct labwc_menu *menu = g_new0(struct labwc_menu, 1);
+	menu->desktop_options.fields = APP_FIELD_FILENAME | APP_FIELD_ICON;
+	menu->arena = arena_create();
+	menu->path_index = path_index_create();
+	menu->scanned_dirs = g_ptr_array_new_with_free_func(g_free);
+	menu->scanned_files = g_ptr_array_new_with_free_func(g_free);
+	menu->rendered = g_string_new(NULL);
+	return menu;
+}
+
+/* Forget whatever was derived from the apps and directories */
+static void
+invalidate_views(struct labwc_menu *menu)
+{
+	g_clear_pointer(&menu->dir_views, g_free);
+	g_clear_pointer(&menu->app_views, g_free);
+	g_clear_pointer(&menu->rendered_request, g_free);
+	g_string_truncate(menu->rendered, 0);
+}
+
+EXPORT void
+labwc_menu_destroy(struct labwc_menu *menu)
+{
+	if (!menu) {
+		return;
+	}
+	invalidate_views(menu);
+	g_string_free(menu->rendered, TRUE);
+	desktop_entries_destroy(menu->apps);
+	directory_entries_destroy(menu->dirs);
+	g_ptr_array_free(menu->scanned_dirs, TRUE);
+	g_ptr_array_free(menu->scanned_files, TRUE);
+	ignore_destroy(menu->ignore);
+	g_free(menu->ignore_file);
+	path_index_destroy(menu->path_index);
+	arena_destroy(menu->arena);
+	g_free(menu);
+}
+
+EXPORT void
+labwc_menu_set_jobs(struct labwc_menu *menu, int jobs)
+{
+	menu->desktop_options.jobs = jobs;
+}
+
+EXPORT void
+labwc_menu_set_ignore_file(struct labwc_menu *menu, const char *filename)
+{
+	g_free(menu->ignore_file);
+	menu->ignore_file = g_strdup(filename);
+}
+
+void
+labwc_menu_set_fields(struct labwc_menu *menu, unsigned int fields)
+{
+	menu->desktop_options.fields = fields;
+}
+
+EXPORT void
+labwc_menu_scan(struct labwc_menu *menu)
+{
+	invalidate_views(menu);
+	ignore_destroy(menu->ignore);
+	menu->ignore = ignore_create(menu->ignore_file);
+
+	uint64_t start = stats_begin();
+	directory_entries_destroy(menu->dirs);
+	menu->dirs = directory_entries_create(NULL);
+	stats_end(STATS_DIRECTORIES, start);
+
+	/* The arena is reused from one scan to the next */
+	desktop_entries_destroy(menu->apps);
+	arena_reset(menu->arena);
+	g_ptr_array_set_size(menu->scanned_dirs, 0);
+	g_ptr_array_set_size(menu->scanned_files, 0);
+	menu->desktop_options.ignore = menu->ignore;
+	menu->desktop_options.path_index = menu->path_index;
+	menu->apps = desktop_entries_create(menu->arena, &menu->desktop_options,
+		menu->scanned_dirs, menu->scanned_files);
+}
+
+void
+labwc_menu_localize(struct labwc_menu *menu, const char *lang)
+{
+	invalidate_views(menu);
+	desktop_entries_localize(menu->apps, menu->arena, lang);
+	uint64_t start = stats_begin();
+	directory_entries_destroy(menu->dirs);
+	menu->dirs = directory_entries_create(lang);
+	stats_end(STATS_DIRECTORIES, start);
+}
+
+GPtrArray *
+labwc_menu_scanned_dirs(struct labwc_menu *menu)
+{
+	return menu->scanned_dirs;
+}
+
+GPtrArray *
+labwc_menu_scanned_files(struct labwc_menu *menu)
+{
+	return menu->scanned_files;
+}
+
+EXPORT const struct labwc_menu_dir *
+labwc_menu_dirs(struct labwc_menu *menu, size_t *nr_dirs)
+{
+	if (!menu->dir_views) {
+		/* The same order as menu_model_create() puts them in */
+		guint n = g_list_length(menu->dirs);
+		menu->dir_views = g_new0(struct labwc_menu_dir, n);
+		menu->nr_dir_views = 0;
+		for (int categorized = 1; categorized >= 0; categorized--) {
+			for (GList *iter = menu->dirs; iter; iter = iter->next) {
+				struct dir *dir = iter->data;
+				if (!dir->categories != !categorized) {
+					continue;
+				}
+				menu->dir_views[menu->nr_dir_views++] =
+					(struct labwc_menu_dir){
+						.id = dir->name,
+						.name_localized = dir->name_localized,
+						.icon = dir->icon,
+					};
+			}
+		}
+	}
+	*nr_dirs = menu->nr_dir_views;
+	return menu->dir_views;
+}
+
+EXPORT const struct labwc_menu_app *
+labwc_menu_dir_apps(struct labwc_menu *menu,
+		const struct labwc_menu_options *options, const char *id,
+		size_t *nr_apps)
+{
+	g_clear_pointer(&menu->app_views, g_free);
+	*nr_apps = 0;
+
+	struct menu_model *model = menu_model_create(options, menu->dirs,
+		menu->apps, menu->path_index);
+	for (guint i = 0; i < model->nr_dirs; i++) {
+		if (strcmp(model->dirs[i]->name, id)) {
+			continue;
+		}
+		GPtrArray *apps = model->dir_apps[i];
+		menu->app_views = g_new0(struct labwc_menu_app, apps->len + 1);
+		for (guint j = 0; j < apps->len; j++) {
+			struct app *app = g_ptr_array_index(apps, j);
+			menu->app_views[j] = (struct labwc_menu_app){
+				.filename = app->filename,
+				.name = app->name,
+				.name_localized = app->name_localized,
+				.exec = app->exec,
+				.icon = app->icon,
+				.categories = app->categories,
+				.terminal = app->terminal,
+			};
+		}
+		*nr_apps = apps->len;
+		break;
+	}
+	menu_model_destroy(model);
+	return menu->app_views;
+}
+
+void
+labwc_menu_render_request(struct labwc_menu *menu, GString *buf,
+		const char *request, struct menu_update *update)
+{
+	struct labwc_menu_options options;
+	render_request_parse(request, &options);
+	struct menu_model *model = menu_model_create(&options, menu->dirs,
+		menu->apps, menu->path_index);
+	render_menu(buf, model, update);
+	menu_model_destroy(model);
+}
+
+EXPORT size_t
+labwc_menu_render(struct labwc_menu *menu,
+		const struct labwc_menu_options *options, char *buf, size_t size)
+{
+	char *request = render_request_create(options);
+	if (g_strcmp0(request, menu->rendered_request)) {
+		g_string_truncate(menu->rendered, 0);
+		labwc_menu_render_request(menu, menu->rendered, request, NULL);
+		g_free(menu->rendered_request);
+		menu->rendered_request = request;
+	} else {
+		g_free(request);
+	}
+
+	size_t len = menu->rendered->len;
+	if (size) {
+		size_t n = MIN(len, size - 1);
+		memcpy(buf, menu->rendered->str, n);
+		buf[n] = '\0';
+	}
+	return len;
+}
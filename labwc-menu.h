@@ -0,0 +1,103 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_MENU_H
+#define LABWC_MENU_H
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * liblabwc-menu - build labwc menus in-process
+ *
+ * A context holds one scan of the system .desktop files, which can be
+ * queried and rendered any number of times and rescanned when the files
+ * change. Contexts are independent of each other, but a context must not be
+ * used by more than one thread at a time. Names are sorted in the LC_COLLATE
+ * order of the process and localized for $LANG.
+ */
+struct labwc_menu;
+
+enum labwc_menu_format {
+	LABWC_MENU_XML = 0,
+	LABWC_MENU_JSON,
+	LABWC_MENU_JSONL,
+};
+
+/* The options of labwc-menu-generator which change the menu */
+struct labwc_menu_options {
+	enum labwc_menu_format format;
+	/* Leave out the header and footer */
+	bool bare;
+	/* Render an openbox pipe menu */
+	bool pipemenu;
+	/* Add icon="" attributes */
+	bool icons;
+	/* Add the .desktop filenames as comments */
+	bool desktop_filename;
+	/* Hide apps whose Exec= program is not in $PATH */
+	bool check_exec;
+	/* Put each app in the first of its directories only */
+	bool no_duplicates;
+	/* Prefix for the commands of Terminal=true apps, or NULL */
+	const char *terminal_prefix;
+};
+
+/*
+ * The strings of apps and directories belong to the context and are valid
+ * until the next labwc_menu_scan() or labwc_menu_destroy(). Fields which are
+ * not set in the .desktop file are NULL.
+ */
+struct labwc_menu_app {
+	const char *filename;
+	const char *name;
+	const char *name_localized;
+	const char *exec;
+	const char *icon;
+	const char *categories;
+	bool terminal;
+};
+
+struct labwc_menu_dir {
+	const char *id;
+	const char *name_localized;
+	const char *icon;
+};
+
+struct labwc_menu *labwc_menu_create(void);
+void labwc_menu_destroy(struct labwc_menu *menu);
+
+/*
+ * labwc_menu_set_jobs - set the number of threads parsing .desktop files.
+ * The default of 0 means one per online CPU.
+ */
+void labwc_menu_set_jobs(struct labwc_menu *menu, int jobs);
+
+/*
+ * labwc_menu_set_ignore_file - skip the .desktop files listed in @filename,
+ * which is read again by each scan. NULL skips none.
+ */
+void labwc_menu_set_ignore_file(struct labwc_menu *menu, const char *filename);
+
+/* labwc_menu_scan - parse the .desktop files, replacing any previous scan */
+void labwc_menu_scan(struct labwc_menu *menu);
+
+/* labwc_menu_dirs - return the directories in menu order */
+const struct labwc_menu_dir *labwc_menu_dirs(struct labwc_menu *menu,
+	size_t *nr_dirs);
+
+/*
+ * labwc_menu_dir_apps - return the apps shown in directory @id with
+ * @options, in sort order. The array is valid until the next call.
+ */
+const struct labwc_menu_app *labwc_menu_dir_apps(struct labwc_menu *menu,
+	const struct labwc_menu_options *options, const char *id,
+	size_t *nr_apps);
+
+/*
+ * labwc_menu_render - write the menu into @buf like snprintf(), so that no
+ * more than @size bytes are written including the terminating NUL. Returns
+ * the length of the whole menu, which is rendered only once when called
+ * again with the same options to fill a larger buffer.
+ */
+size_t labwc_menu_render(struct labwc_menu *menu,
+	const struct labwc_menu_options *options, char *buf, size_t size);
+
+#endif /* LABWC_MENU_H */
@@ -4,48 +4,79 @@
  * Copyright (C) Johan Malm 2022
  */
 #define _POSIX_C_SOURCE 200809L
-#include <assert.h>
 #include <dirent.h>
+#include <errno.h>
 #include <getopt.h>
 #include <glib.h>
+#include <limits.h>
+#include <locale.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "batch.h"
+#include "collate.h"
+#include "daemon.h"
 #include "desktop.h"
-#include "ignore.h"
-#include "schema.h"
-
-static bool no_duplicates;
-static bool no_footer;
-static bool no_header;
-static bool pipemenu;
-static bool show_desktop_filename;
-static bool show_icons;
-static char *terminal_prefix;
+#include "labwc-menu-private.h"
+#include "menu-cache.h"
+#include "menu-update.h"
+#include "render.h"
+#include "stats.h"
+#include "trace.h"
+#include "xml-writer.h"
+
+static struct labwc_menu_options options;
+
+enum {
+	OPT_BATCH = 256,
+	OPT_CONNECT,
+	OPT_DAEMON,
+	OPT_FORMAT,
+	OPT_STATS,
+	OPT_UPDATE,
+};
 
 static const struct option long_options[] = {
 	{"bare", no_argument, NULL, 'b'},
+	{"batch", required_argument, NULL, OPT_BATCH},
+	{"check-exec", no_argument, NULL, 'e'},
+	{"connect", no_argument, NULL, OPT_CONNECT},
+	{"daemon", no_argument, NULL, OPT_DAEMON},
 	{"desktop", no_argument, NULL, 'd'},
+	{"format", required_argument, NULL, OPT_FORMAT},
 	{"help", no_argument, NULL, 'h'},
 	{"ignore", required_argument, NULL, 'i'},
 	{"icons", no_argument, NULL, 'I'},
+	{"jobs", required_argument, NULL, 'j'},
 	{"no-duplicates", no_argument, NULL, 'n'},
 	{"pipemenu", no_argument, NULL, 'p'},
+	{"stats", optional_argument, NULL, OPT_STATS},
 	{"terminal-prefix", required_argument, NULL, 't'},
+	{"update", required_argument, NULL, OPT_UPDATE},
 	{0, 0, 0, 0}
 };
 
 static const char labwc_menu_generator_usage[] =
 "Usage: labwc-menu-generator [options...]\n"
 "  -b, --bare               Show no header or footer\n"
+"      --batch <file>       Write each menu listed in <file> from one scan\n"
+"      --connect            Get the menu from a running daemon\n"
+"      --daemon             Serve menus to --connect clients\n"
 "  -d, --desktop            Add .desktop filename as a comment in the XML output\n"
+"  -e, --check-exec         Hide entries whose Exec= program is not in $PATH\n"
+"      --format <format>    Output xml (default), json or jsonl\n"
 "  -h, --help               Show help message and quit\n"
 "  -i, --ignore <file>      Specify file listing .desktop files to ignore\n"
 "  -I, --icons              Add icon=\"\" attribute\n"
+"  -j, --jobs <n>           Parse .desktop files with <n> threads\n"
 "  -n, --no-duplicates      Limit desktop entries to one directory only\n"
 "  -p, --pipemenu           Output in pipemenu format\n"
-"  -t, --terminal-prefix    Specify prefix for Terminal=true entries\n";
+"      --stats[=json]       Print timings and counters to stderr\n"
+"  -t, --terminal-prefix    Specify prefix for Terminal=true entries\n"
+"      --update <file>      Write the menu to <file>, reusing unchanged parts\n";
 
 static void
 usage(void)
@@ -54,307 +85,201 @@ usage(void)
 	exit(0);
 }
 
-static bool
-ismatch(gchar **dir_categories, const char *app_categories)
+/* The number of threads has to be a positive integer */
+static int
+parse_jobs(const char *arg)
 {
-	for (char **p = dir_categories; *p; p++) {
-		if (!p || !*p || !**p) {
-			continue;
-		}
-		if (strstr(app_categories, *p)) {
-			return true;
-		}
+	char *end;
+	errno = 0;
+	long n = strtol(arg, &end, 10);
+	if (errno || end == arg || *end || n < 1 || n > INT_MAX) {
+		usage();
 	}
-	return false;
+	return n;
 }
 
-static void
-print_app_to_buffer(struct app *app, GString *submenu)
+/* The language of @target if it differs from that of the process */
+static const char *
+target_lang(struct batch_target *target)
 {
-	if (show_desktop_filename) {
-		g_string_append_printf(submenu, "    <!-- %s -->\n", app->filename);
-	}
-
-	/*
-	 * For Terminal=true entries we prefix the command if the user has
-	 * specified a --terminal-prefix value. Typical values would be 'foot',
-	 * 'alacritty -e' or 'xterm -e'. Many terminals use the -e option, but
-	 * not all.
-	 */
-	gchar *command = app->terminal && terminal_prefix ?
-		g_strdup_printf("%s '%s'", terminal_prefix, app->exec) :
-		g_strdup_printf("%s", app->exec);
-	if (!command) {
-		fprintf(stderr, "fatal: cannot allocate");
-		exit(EXIT_FAILURE);
-	}
-
-	g_string_append_printf(submenu, "    <item label=\"%s\"",
-		app->name_localized ? app->name_localized : app->name);
-	if (show_icons && app->icon) {
-		g_string_append_printf(submenu, " icon=\"%s\"", app->icon);
-	}
-	g_string_append_printf(submenu, ">\n");
-
-
-	g_string_append_printf(submenu,
-		"      <action name=\"Execute\"><command>%s</command></action>\n",
-		command);
-	g_string_append_printf(submenu, "    </item>\n");
-
-	g_free(command);
+	return g_strcmp0(target->lang, getenv("LANG")) ? target->lang : NULL;
 }
 
+/* Menus for stdout are kept in @buf to be written in manifest order */
 static bool
-should_not_display(struct app *app)
-{
-	return app->nodisplay || app->tryexec_not_in_path;
-}
-
-#if ! GLIB_CHECK_VERSION(2, 68, 0)
-static void
-compat_replace(GString *s, const char *before, const char *after, int limit)
-{
-	char **split = g_strsplit(s->str, before, limit - 1);
-	g_string_assign(s, g_strjoinv(after, split));
-	g_strfreev(split);
-}
-#define g_string_replace compat_replace
-#endif
-
-static void
-print_apps_in_other_directory(GList *apps, GString *submenu)
+write_target(struct batch_target *target, struct labwc_menu *menu,
+		GString *buf)
 {
-	GList *iter;
-	for (iter = apps; iter; iter = iter->next) {
-		struct app *app = (struct app *)iter->data;
-		if (should_not_display(app) || app->has_been_mapped) {
-			continue;
-		}
-		print_app_to_buffer(app, submenu);
+	uint64_t span = trace_begin();
+	bool ok = true;
+	if (!strcmp(target->output, "-")) {
+		labwc_menu_render_request(menu, buf, target->request, NULL);
+	} else {
+		/* The same options in another language are another menu */
+		char *state = target->lang ? g_strdup_printf("%s %s",
+			target->lang, target->request) : g_strdup(target->request);
+		struct menu_update *update = menu_update_begin(target->output,
+			state);
+		labwc_menu_render_request(menu, buf, target->request, update);
+		uint64_t start = stats_begin();
+		ok = menu_update_finish(update, buf);
+		stats_end(STATS_EMIT, start);
+		g_free(state);
 	}
-	g_string_replace(submenu, "&", "&amp;", 0);
+	trace_end("target", target->output, span);
+	return ok;
 }
 
-struct dir {
-	char *name;
-	char *name_localized;
-	char *icon;
-	char *categories;
-};
-
-static void
-print_apps_for_one_directory(GList *apps, struct dir *dir, GString *submenu)
+/*
+ * Every menu in the manifest is rendered from a single scan. The menus are
+ * written one language at a time, starting with that of the process which
+ * the apps were parsed in, and the apps are localized again for each other
+ * language from the translations kept while parsing.
+ */
+static int
+run_batch(struct labwc_menu *menu, const char *batch_file)
 {
-	gchar **categories = g_strsplit(dir->categories, ";", -1);
-	GList *iter;
-	for (iter = apps; iter; iter = iter->next) {
-		struct app *app = (struct app *)iter->data;
-		if (should_not_display(app)) {
-			continue;
-		}
-
-		/*
-		 * dir->categories often contains a semi-colon at the end,
-		 * giving an empty field which we ignore
-		 */
-		if (!app->categories || app->categories[0] == '\0') {
-			continue;
+	GPtrArray *targets = batch_load(batch_file);
+	if (!targets) {
+		return EXIT_FAILURE;
+	}
+	GPtrArray *langs = g_ptr_array_new();
+	g_ptr_array_add(langs, NULL);
+	for (guint i = 0; i < targets->len; i++) {
+		const char *lang = target_lang(g_ptr_array_index(targets, i));
+		guint j = 0;
+		while (j < langs->len && g_strcmp0(langs->pdata[j], lang)) {
+			j++;
 		}
-
-		/* Only include apps with the right categories */
-		if (!ismatch(categories, app->categories)) {
-			continue;
+		if (j == langs->len) {
+			g_ptr_array_add(langs, (char *)lang);
 		}
-
-		if (no_duplicates && app->has_been_mapped) {
-			continue;
-		}
-		app->has_been_mapped = true;
-		print_app_to_buffer(app, submenu);
 	}
-	g_string_replace(submenu, "&", "&amp;", 0);
-	g_strfreev(categories);
-}
-
-static void
-print_menu(GList *dirs, GList *apps)
-{
-	GString *submenu = g_string_new(NULL);
 
-	if (!no_header) {
-		if (pipemenu) {
-			printf("<openbox_pipe_menu>\n");
-		} else {
-			printf("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
-			printf("<openbox_menu>\n");
-			printf("<menu id=\"root-menu\" label=\"root-menu\">\n");
-		}
+	/* The apps only need the fields which some target shows */
+	unsigned int fields = langs->len > 1 ? APP_FIELD_NAME_TRANSLATIONS : 0;
+	for (guint i = 0; i < targets->len; i++) {
+		struct batch_target *target = g_ptr_array_index(targets, i);
+		struct labwc_menu_options target_options;
+		render_request_parse(target->request, &target_options);
+		fields |= render_fields(&target_options);
 	}
+	labwc_menu_set_fields(menu, fields);
 
-	/* Handle all directories except 'Other' */
-	GList *iter;
-	for (iter = dirs; iter; iter = iter->next) {
-		struct dir *dir = (struct dir *)iter->data;
-		if (!dir->categories) {
-			/* the 'Other' directory */
-			continue;
-		}
-		g_string_erase(submenu, 0, -1);
-		print_apps_for_one_directory(apps, dir, submenu);
-		if (!submenu->len) {
-			continue;
-		}
+	uint64_t span = trace_begin();
+	labwc_menu_scan(menu);
+	trace_end("phase", "desktop_entries_create", span);
 
-		printf("  <menu id=\"%s\" label=\"%s\"", dir->name, dir->name_localized ? : dir->name);
-		if (show_icons && dir->icon) {
-			printf(" icon=\"%s\"", dir->icon);
-		}
-		printf(">\n");
-
-		printf("%s", submenu->str);
-		printf("  </menu> <!-- %s -->\n", dir->name);
+	int ret = 0;
+	GString **bufs = g_new(GString *, targets->len);
+	for (guint i = 0; i < targets->len; i++) {
+		bufs[i] = g_string_new(NULL);
 	}
-
-	/* Put any left over applications in 'Other' */
-	for (iter = dirs; iter; iter = iter->next) {
-		struct dir *dir = (struct dir *)iter->data;
-		if (dir->categories) {
-			continue;
+	for (guint i = 0; i < langs->len; i++) {
+		const char *lang = langs->pdata[i];
+		if (lang) {
+			span = trace_begin();
+			if (!setlocale(LC_COLLATE, lang)) {
+				setlocale(LC_COLLATE, "C");
+			}
+			collate_locale_changed();
+			labwc_menu_localize(menu, lang);
+			trace_end("phase", "desktop_entries_localize", span);
 		}
-		g_string_erase(submenu, 0, -1);
-		print_apps_in_other_directory(apps, submenu);
-		if (!submenu->len) {
-			continue;
+		for (guint j = 0; j < targets->len; j++) {
+			struct batch_target *target = g_ptr_array_index(targets, j);
+			if (!g_strcmp0(target_lang(target), lang)
+					&& !write_target(target, menu, bufs[j])) {
+				ret = EXIT_FAILURE;
+			}
 		}
-		printf("  <menu id=\"%s\" label=\"%s\"", dir->name, dir->name_localized ? : dir->name);
-		if (show_icons && dir->icon) {
-			printf(" icon=\"%s\"", dir->icon);
-		}
-		printf(">\n");
-
-		printf("%s", submenu->str);
-		printf("  </menu> <!-- %s -->\n", dir->name);
 	}
 
-	if (!no_footer) {
-		if (pipemenu) {
-			printf("</openbox_pipe_menu>\n");
-		} else {
-			printf("</menu> <!-- root-menu -->\n");
-			printf("</openbox_menu>\n");
+	uint64_t start = stats_begin();
+	for (guint i = 0; i < targets->len; i++) {
+		if (bufs[i]->len) {
+			xml_writev(STDOUT_FILENO, &(struct iovec){
+				bufs[i]->str, bufs[i]->len }, 1);
 		}
+		g_string_free(bufs[i], TRUE);
 	}
-
-	g_string_free(submenu, TRUE);
-}
-
-static int
-compare_dir_name(const void *a, const void *b)
-{
-	const struct dir *aa = (struct dir *)a;
-	const struct dir *bb = (struct dir *)b;
-	const char *aa_name, *bb_name;
-
-	/*
-	 * We use g_utf8_casefold+strcmp instead of merely strcasecmp to
-	 * correctly sort languages other than English.
-	 */
-	aa_name = aa->name_localized ? aa->name_localized : aa->name;
-	bb_name = bb->name_localized ? bb->name_localized : bb->name;
-	aa_name = g_utf8_casefold(aa_name, -1);
-	bb_name = g_utf8_casefold(bb_name, -1);
-	int ret = strcmp(aa_name, bb_name);
-	g_free((void *)aa_name);
-	g_free((void *)bb_name);
+	g_free(bufs);
+	stats_end(STATS_EMIT, start);
+	g_ptr_array_free(langs, TRUE);
+	g_ptr_array_free(targets, TRUE);
 	return ret;
 }
 
-GList *directory_entries_create(void)
-{
-	GList *dirs = NULL;
-
-	/* Schema defined in schema.h */
-	for (int i = 0; schema[i].key; i++) {
-		static struct dir *dir;
-		char *key = schema[i].key;
-		char *value = schema[i].value;
-
-		/* The keyword 'Name' starts a new directory section */
-		if (!strcmp("Name", key)) {
-			dir = calloc(1, sizeof(struct dir));
-			dir->name = strdup(value);
-			dirs = g_list_append(dirs, dir);
-		}
-		assert(dir);
-
-		if (!strcmp("Categories", key)) {
-			dir->categories = strdup(value);
-		} else if (!strcmp("Icon", key)) {
-			dir->icon = strdup(value);
-		}
-
-		if (!strcmp(key, name_llcc_get())) {
-			dir->name_localized = strdup(value);
-		}
-		if (dir->name_localized) {
-			continue;
-		}
-		if (!strcmp(key, name_ll_get())) {
-			dir->name_localized = strdup(value);
-		}
-	}
-	dirs = g_list_sort(dirs, (GCompareFunc)compare_dir_name);
-	return dirs;
-}
-
-void
-directory_entries_destroy(GList *dirs)
-{
-	GList *iter;
-	for (iter = dirs; iter; iter = iter->next) {
-		struct dir *dir = (struct dir *)iter->data;
-		g_free(dir->name);
-		g_free(dir->name_localized);
-		g_free(dir->categories);
-		g_free(dir->icon);
-		g_free(dir);
-	}
-	g_list_free(dirs);
-}
-
 int
 main(int argc, char **argv)
 {
+	bool use_daemon = false, run_daemon = false;
+	bool show_stats = false, stats_json = false;
+	char *ignore_file = NULL, *update_file = NULL, *batch_file = NULL;
+	int jobs = 0;
 	int c;
+
+	/* Names are sorted in the order of the user's language */
+	setlocale(LC_COLLATE, "");
+	setlocale(LC_CTYPE, "");
+
 	while (1) {
 		int index = 0;
-		c = getopt_long(argc, argv, "bdhi:Inpt:", long_options, &index);
+		c = getopt_long(argc, argv, "bdehi:Ij:npt:", long_options, &index);
 		if (c == -1) {
 			break;
 		}
 		switch (c) {
 		case 'b':
-			no_footer = true;
-			no_header = true;
+			options.bare = true;
+			break;
+		case OPT_BATCH:
+			batch_file = optarg;
+			break;
+		case OPT_CONNECT:
+			use_daemon = true;
+			break;
+		case OPT_DAEMON:
+			run_daemon = true;
 			break;
 		case 'd':
-			show_desktop_filename = true;
+			options.desktop_filename = true;
+			break;
+		case 'e':
+			options.check_exec = true;
+			break;
+		case OPT_FORMAT:
+			if (!render_format_lookup(optarg, &options.format)) {
+				usage();
+			}
 			break;
 		case 'i':
-			ignore_init(optarg);
+			ignore_file = optarg;
 			break;
 		case 'I':
-			show_icons = true;
+			options.icons = true;
+			break;
+		case 'j':
+			jobs = parse_jobs(optarg);
 			break;
 		case 'n':
-			no_duplicates = true;
+			options.no_duplicates = true;
 			break;
 		case 'p':
-			pipemenu = true;
+			options.pipemenu = true;
 			break;
 		case 't':
-			terminal_prefix = optarg;
+			options.terminal_prefix = optarg;
+			break;
+		case OPT_STATS:
+			if (optarg && strcmp(optarg, "json")) {
+				usage();
+			}
+			show_stats = true;
+			stats_json = optarg != NULL;
+			break;
+		case OPT_UPDATE:
+			update_file = optarg;
 			break;
 		case 'h':
 		default:
@@ -364,15 +289,99 @@ main(int argc, char **argv)
 	if (optind < argc) {
 		usage();
 	}
+	if (batch_file && (use_daemon || run_daemon || update_file)) {
+		usage();
+	}
 
-	GList *apps = desktop_entries_create();
-	GList *dirs = directory_entries_create();
+	if (run_daemon) {
+		struct labwc_menu *menu = labwc_menu_create();
+		labwc_menu_set_jobs(menu, jobs);
+		labwc_menu_set_ignore_file(menu, ignore_file);
+		int ret = daemon_run(menu, ignore_file);
+		labwc_menu_destroy(menu);
+		return ret;
+	}
 
-	print_menu(dirs, apps);
+	if (show_stats) {
+		stats_enable();
+	}
+	trace_init();
+	if (batch_file) {
+		struct labwc_menu *menu = labwc_menu_create();
+		labwc_menu_set_jobs(menu, jobs);
+		labwc_menu_set_ignore_file(menu, ignore_file);
+		int ret = run_batch(menu, batch_file);
+		labwc_menu_destroy(menu);
+		trace_finish();
+		stats_print(stats_json);
+		return ret;
+	}
+	uint64_t span = trace_begin();
+
+	/* Fall back on generating the menu if there is no daemon */
+	char *request = render_request_create(&options);
+	if (use_daemon && !update_file && daemon_connect(request, ignore_file)) {
+		g_free(request);
+		trace_end("phase", "connect", span);
+		trace_finish();
+		stats_print(stats_json);
+		return 0;
+	}
+	uint64_t start = stats_begin();
+	bool is_replayed = !update_file
+		&& menu_cache_replay(request, ignore_file);
+	stats_end(STATS_REPLAY, start);
+	trace_end("phase", "replay", span);
+	if (is_replayed) {
+		g_free(request);
+		trace_finish();
+		stats_print(stats_json);
+		return 0;
+	}
 
-	desktop_entries_destroy(apps);
-	directory_entries_destroy(dirs);
-	ignore_finish();
+	span = trace_begin();
+	struct labwc_menu *menu = labwc_menu_create();
+	labwc_menu_set_jobs(menu, jobs);
+	labwc_menu_set_ignore_file(menu, ignore_file);
+	labwc_menu_set_fields(menu, render_fields(&options));
+	labwc_menu_scan(menu);
+	GString *buf = g_string_new(NULL);
+	trace_end("phase", "desktop_entries_create", span);
+
+	span = trace_begin();
+	struct menu_update *update = NULL;
+	if (update_file) {
+		update = menu_update_begin(update_file, request);
+	}
+	labwc_menu_render_request(menu, buf, request, update);
+	trace_end("phase", "print_menu", span);
+
+	/* An updated menu file replaces both stdout and the menu cache */
+	int ret = 0;
+	span = trace_begin();
+	start = stats_begin();
+	if (update) {
+		ret = menu_update_finish(update, buf) ? 0 : EXIT_FAILURE;
+	} else {
+		xml_writev(STDOUT_FILENO,
+			&(struct iovec){ buf->str, buf->len }, 1);
+	}
+	stats_end(STATS_EMIT, start);
+	trace_end("phase", "write", span);
+
+	if (!update_file) {
+		span = trace_begin();
+		menu_cache_store(request, ignore_file, buf,
+			labwc_menu_scanned_dirs(menu),
+			labwc_menu_scanned_files(menu));
+		trace_end("phase", "menu_cache_store", span);
+	}
+	trace_finish();
+	stats_print(stats_json);
 
-	return 0;
+	g_free(request);
+	g_string_free(buf, TRUE);
+	labwc_menu_destroy(menu);
+
+	return ret;
 }
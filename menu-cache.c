@@ -0,0 +1,409 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Cache of rendered menus
+ *
+ * Each menu is stored in $XDG_CACHE_HOME/labwc-menu-generator/ under a name
+ * derived from everything that affects its content apart from the
+ * applications directories: the options, the environment and the contents of
+ * the ignore file. The file starts with one line per directory that was
+ * scanned and per .desktop file that was read, followed by an empty line and
+ * the menu itself:
+ *
+ *   D <inode> <mtime> <mtime_nsec> <path>
+ *   M <path>                      (applications dir or file not present)
+ *   F <inode> <size> <mtime> <mtime_nsec> <path>
+ *
+ * The menu is replayed if none of the directories and files have changed.
+ * Directories catch files being added, removed or replaced, and the file
+ * lines catch those edited in place.
+ *
+ * Menus for other options or environments pile up, so only the
+ * MENU_CACHE_MAX_ENTRIES most recently stored are kept.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <glib.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef HAVE_SENDFILE
+#include <sys/sendfile.h>
+#endif
+#include "desktop.h"
+#include "menu-cache.h"
+#include "xml-writer.h"
+
+#define MENU_CACHE_VERSION "2"
+#define MENU_CACHE_PREFIX "menu-"
+#define MENU_CACHE_MAX_ENTRIES 32
+
+static const char *fingerprint_env[] = {
+	"LANG",
+	"LC_ALL",
+	"LC_COLLATE",
+	"LC_CTYPE",
+	"PATH",
+	"HOME",
+	"XDG_DATA_HOME",
+	"XDG_DATA_DIRS",
+	"LABWC_MENU_GENERATOR_DEBUG_FIRST_DIR_ONLY",
+	NULL
+};
+
+static void
+checksum_add(GChecksum *checksum, const char *s)
+{
+	/* Include the NUL so that "ab" + "c" differs from "a" + "bc" */
+	if (s) {
+		g_checksum_update(checksum, (const guchar *)s, strlen(s) + 1);
+	} else {
+		g_checksum_update(checksum, (const guchar *)"\1", 2);
+	}
+}
+
+void
+menu_cache_checksum_environment(GChecksum *checksum)
+{
+	for (const char **env = fingerprint_env; *env; env++) {
+		checksum_add(checksum, getenv(*env));
+	}
+}
+
+static char *
+cache_filename(const char *request, const char *ignore_file)
+{
+	GChecksum *checksum = g_checksum_new(G_CHECKSUM_SHA256);
+	checksum_add(checksum, MENU_CACHE_VERSION);
+	checksum_add(checksum, request);
+	menu_cache_checksum_environment(checksum);
+
+	/* A rebuilt binary may well render menus differently */
+	struct stat sb;
+	if (stat("/proc/self/exe", &sb) == 0) {
+		char *s = g_strdup_printf("%ju %jd %jd", (uintmax_t)sb.st_ino,
+			(intmax_t)sb.st_size, (intmax_t)sb.st_mtime);
+		checksum_add(checksum, s);
+		g_free(s);
+	}
+
+	char *contents = NULL;
+	if (ignore_file && *ignore_file) {
+		g_file_get_contents(ignore_file, &contents, NULL, NULL);
+	}
+	checksum_add(checksum, contents);
+	g_free(contents);
+
+	char *name = g_strconcat(MENU_CACHE_PREFIX,
+		g_checksum_get_string(checksum), NULL);
+	char *filename = g_build_filename(g_get_user_cache_dir(),
+		"labwc-menu-generator", name, NULL);
+	g_free(name);
+	g_checksum_free(checksum);
+	return filename;
+}
+
+static bool
+is_dir_unchanged(char *line)
+{
+	char *p = line + 2;
+	uintmax_t ino = strtoumax(p, &p, 10);
+	intmax_t mtime = strtoimax(p, &p, 10);
+	long mtime_nsec = strtol(p, &p, 10);
+	if (*p != ' ') {
+		return false;
+	}
+
+	struct stat sb;
+	if (stat(p + 1, &sb) == -1) {
+		return false;
+	}
+	return (uintmax_t)sb.st_ino == ino && (intmax_t)sb.st_mtim.tv_sec == mtime
+		&& sb.st_mtim.tv_nsec == mtime_nsec;
+}
+
+static bool
+is_file_unchanged(char *line)
+{
+	char *p = line + 2;
+	uintmax_t ino = strtoumax(p, &p, 10);
+	intmax_t size = strtoimax(p, &p, 10);
+	intmax_t mtime = strtoimax(p, &p, 10);
+	long mtime_nsec = strtol(p, &p, 10);
+	if (*p != ' ') {
+		return false;
+	}
+
+	struct stat sb;
+	if (stat(p + 1, &sb) == -1) {
+		return false;
+	}
+	return (uintmax_t)sb.st_ino == ino && (intmax_t)sb.st_size == size
+		&& (intmax_t)sb.st_mtim.tv_sec == mtime
+		&& sb.st_mtim.tv_nsec == mtime_nsec;
+}
+
+/* Read the directory and file lines up to and including the empty line */
+static bool
+are_dirs_unchanged(FILE *fp)
+{
+	char *line = NULL;
+	size_t size = 0;
+	ssize_t len;
+	bool unchanged = false;
+
+	while ((len = getline(&line, &size, fp)) > 0) {
+		if (line[len - 1] != '\n') {
+			break;
+		}
+		line[len - 1] = '\0';
+		if (line[0] == '\0') {
+			unchanged = true;
+			break;
+		}
+		if (!strncmp(line, "D ", 2)) {
+			if (!is_dir_unchanged(line)) {
+				break;
+			}
+		} else if (!strncmp(line, "F ", 2)) {
+			if (!is_file_unchanged(line)) {
+				break;
+			}
+		} else if (!strncmp(line, "M ", 2)) {
+			struct stat sb;
+			if (stat(line + 2, &sb) == 0) {
+				break;
+			}
+		} else {
+			break;
+		}
+	}
+	free(line);
+	return unchanged;
+}
+
+static bool
+write_all(int fd, const char *buf, size_t len)
+{
+	while (len) {
+		ssize_t n = write(fd, buf, len);
+		if (n == -1 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			return false;
+		}
+		buf += n;
+		len -= n;
+	}
+	return true;
+}
+
+static void
+copy_to_stdout(int fd, off_t offset, off_t len)
+{
+#ifdef HAVE_SENDFILE
+	while (len > 0) {
+		ssize_t n = sendfile(STDOUT_FILENO, fd, &offset, len);
+		if (n == -1 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			break;
+		}
+		len -= n;
+	}
+#endif
+
+	/* sendfile() is not available everywhere or for every stdout */
+	char buf[65536];
+	while (len > 0) {
+		ssize_t n = pread(fd, buf, MIN((off_t)sizeof(buf), len), offset);
+		if (n == -1 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0 || !write_all(STDOUT_FILENO, buf, n)) {
+			break;
+		}
+		offset += n;
+		len -= n;
+	}
+}
+
+bool
+menu_cache_replay(const char *request, const char *ignore_file)
+{
+	char *filename = cache_filename(request, ignore_file);
+	FILE *fp = fopen(filename, "r");
+	g_free(filename);
+	if (!fp) {
+		return false;
+	}
+
+	struct stat sb;
+	if (!are_dirs_unchanged(fp) || fstat(fileno(fp), &sb) == -1) {
+		fclose(fp);
+		return false;
+	}
+	off_t offset = ftell(fp);
+	fflush(stdout);
+	copy_to_stdout(fileno(fp), offset, sb.st_size - offset);
+	fclose(fp);
+	return true;
+}
+
+struct cache_entry {
+	char *path;
+	struct timespec mtime;
+};
+
+static void
+free_cache_entry(gpointer data)
+{
+	struct cache_entry *entry = data;
+	g_free(entry->path);
+	g_free(entry);
+}
+
+static gint
+compare_newest_first(gconstpointer a, gconstpointer b)
+{
+	const struct cache_entry *x = *(struct cache_entry *const *)a;
+	const struct cache_entry *y = *(struct cache_entry *const *)b;
+	if (x->mtime.tv_sec != y->mtime.tv_sec) {
+		return x->mtime.tv_sec < y->mtime.tv_sec ? 1 : -1;
+	}
+	if (x->mtime.tv_nsec != y->mtime.tv_nsec) {
+		return x->mtime.tv_nsec < y->mtime.tv_nsec ? 1 : -1;
+	}
+	return 0;
+}
+
+/*
+ * Only names of the exact length of a cache file are looked at, so that
+ * the temporary files of other runs storing a menu are left alone.
+ */
+static void
+evict_old_menus(const char *dirname)
+{
+	DIR *dp = opendir(dirname);
+	if (!dp) {
+		return;
+	}
+	const size_t name_len = strlen(MENU_CACHE_PREFIX)
+		+ g_checksum_type_get_length(G_CHECKSUM_SHA256) * 2;
+	GPtrArray *entries = g_ptr_array_new_with_free_func(free_cache_entry);
+	struct dirent *dirent;
+	while ((dirent = readdir(dp))) {
+		const char *name = dirent->d_name;
+		if (!g_str_has_prefix(name, MENU_CACHE_PREFIX)
+				|| strlen(name) != name_len) {
+			continue;
+		}
+		char *path = g_build_filename(dirname, name, NULL);
+		struct stat sb;
+		if (stat(path, &sb) == -1) {
+			g_free(path);
+			continue;
+		}
+		struct cache_entry *entry = g_new(struct cache_entry, 1);
+		entry->path = path;
+		entry->mtime = sb.st_mtim;
+		g_ptr_array_add(entries, entry);
+	}
+	closedir(dp);
+
+	if (entries->len > MENU_CACHE_MAX_ENTRIES) {
+		g_ptr_array_sort(entries, compare_newest_first);
+		for (guint i = MENU_CACHE_MAX_ENTRIES; i < entries->len; i++) {
+			struct cache_entry *entry = g_ptr_array_index(entries, i);
+			unlink(entry->path);
+		}
+	}
+	g_ptr_array_free(entries, TRUE);
+}
+
+void
+menu_cache_store(const char *request, const char *ignore_file, GString *menu,
+		GPtrArray *scanned_dirs, GPtrArray *scanned_files)
+{
+	/*
+	 * A directory modified just now could be modified again without its
+	 * mtime changing, so we do not cache menus generated from it.
+	 */
+	time_t racy = time(NULL) - 2;
+
+	GString *buf = g_string_new(NULL);
+	GHashTable *scanned = g_hash_table_new(g_str_hash, g_str_equal);
+	for (guint i = 0; i < scanned_dirs->len; i++) {
+		char *path = g_ptr_array_index(scanned_dirs, i);
+		struct stat sb;
+		if (strchr(path, '\n') || stat(path, &sb) == -1
+				|| sb.st_mtime >= racy) {
+			goto out;
+		}
+		g_string_append_printf(buf, "D %ju %jd %ld %s\n",
+			(uintmax_t)sb.st_ino, (intmax_t)sb.st_mtim.tv_sec,
+			(long)sb.st_mtim.tv_nsec, path);
+		g_hash_table_add(scanned, path);
+	}
+
+	/* Files are cached with the state they were in when they were read */
+	for (guint i = 0; i < scanned_files->len; i++) {
+		struct scanned_file *file = g_ptr_array_index(scanned_files, i);
+		if (strchr(file->path, '\n') || file->mtime >= racy) {
+			goto out;
+		}
+		if (file->is_missing) {
+			g_string_append_printf(buf, "M %s\n", file->path);
+			continue;
+		}
+		g_string_append_printf(buf, "F %ju %jd %jd %ld %s\n",
+			(uintmax_t)file->ino, (intmax_t)file->size,
+			(intmax_t)file->mtime, file->mtime_nsec, file->path);
+	}
+
+	GPtrArray *paths = desktop_search_paths_create();
+	for (guint i = 0; i < paths->len; i++) {
+		char *path = g_ptr_array_index(paths, i);
+		if (!g_hash_table_contains(scanned, path) && !strchr(path, '\n')) {
+			g_string_append_printf(buf, "M %s\n", path);
+		}
+	}
+	g_ptr_array_free(paths, TRUE);
+
+	g_string_append_c(buf, '\n');
+
+	/* The header and the menu go out together, without copying the menu */
+	char *filename = cache_filename(request, ignore_file);
+	char *dirname = g_path_get_dirname(filename);
+	char *tmpname = g_strconcat(filename, ".XXXXXX", NULL);
+	int fd = -1;
+	if (g_mkdir_with_parents(dirname, 0700) == 0) {
+		fd = g_mkstemp(tmpname);
+	}
+	if (fd != -1) {
+		struct iovec iov[] = {
+			{ buf->str, buf->len },
+			{ menu->str, menu->len },
+		};
+		bool ok = xml_writev(fd, iov, G_N_ELEMENTS(iov));
+		if (close(fd) == -1 || !ok || rename(tmpname, filename) == -1) {
+			unlink(tmpname);
+		} else {
+			evict_old_menus(dirname);
+		}
+	}
+	g_free(tmpname);
+	g_free(dirname);
+	g_free(filename);
+out:
+	g_hash_table_destroy(scanned);
+	g_string_free(buf, TRUE);
+}
@@ -0,0 +1,28 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef MENU_CACHE_H
+#define MENU_CACHE_H
+#include <glib.h>
+#include <stdbool.h>
+
+/*
+ * menu_cache_replay - copy the menu cached for @request to stdout
+ * Returns false if nothing is cached for @request in the current environment
+ * or if any applications directory has changed since it was cached.
+ */
+bool menu_cache_replay(const char *request, const char *ignore_file);
+
+/*
+ * menu_cache_store - cache @menu for @request along with the state of the
+ * @scanned_dirs and the struct scanned_file @scanned_files it was generated
+ * from, and remove the menus stored longest ago beyond a fixed number
+ */
+void menu_cache_store(const char *request, const char *ignore_file,
+	GString *menu, GPtrArray *scanned_dirs, GPtrArray *scanned_files);
+
+/*
+ * menu_cache_checksum_environment - add the environment variables which
+ * menus depend on to @checksum
+ */
+void menu_cache_checksum_environment(GChecksum *checksum);
+
+#endif /* MENU_CACHE_H */
@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Incremental updates of a menu file
+ *
+ * The state is kept in <menu file>.state, and the blocks are read back from
+ * the menu file itself, so the state is only trusted while the menu file is
+ * the one that was written with it:
+ *   header:     "LMGMENU <version>\n"
+ *   request:    "R <request>\n"
+ *   menu file:  "S <inode> <size> <mtime> <mtime_nsec>\n"
+ *   block:      "B <hash> <offset> <length> <menu id>\n"
+ */
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include <errno.h>
+#include <glib.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "menu-update.h"
+#include "xml-writer.h"
+
+#define STATE_HEADER "LMGMENU 1\n"
+#define STATE_SUFFIX ".state"
+
+struct block {
+	uint64_t hash;
+	size_t offset, len;
+};
+
+struct menu_update {
+	char *filename;
+	char *request;
+	/* The previous menu, or NULL if its state was missing or stale */
+	char *old_menu;
+	size_t old_len;
+	mode_t mode;
+	/* Blocks of the previous menu by menu id */
+	GHashTable *old_blocks;
+	/* Blocks of the new menu in order, with their ids */
+	GArray *blocks;
+	GPtrArray *ids;
+};
+
+uint64_t
+menu_update_hash(uint64_t hash, const char *s)
+{
+	/* FNV-1a, with the NUL so that "ab" + "c" differs from "a" + "bc" */
+	if (!s) {
+		s = "\1";
+	}
+	do {
+		hash ^= (unsigned char)*s;
+		hash *= UINT64_C(1099511628211);
+	} while (*s++);
+	return hash;
+}
+
+static bool
+is_menu_unchanged(const char *line, struct stat *sb)
+{
+	uintmax_t ino;
+	intmax_t size, mtime;
+	long mtime_nsec;
+	if (sscanf(line, "S %ju %jd %jd %ld", &ino, &size, &mtime,
+			&mtime_nsec) != 4) {
+		return false;
+	}
+	return (uintmax_t)sb->st_ino == ino && (intmax_t)sb->st_size == size
+		&& (intmax_t)sb->st_mtim.tv_sec == mtime
+		&& sb->st_mtim.tv_nsec == mtime_nsec;
+}
+
+static void
+load_state(struct menu_update *update)
+{
+	struct stat sb;
+	if (stat(update->filename, &sb) == -1) {
+		return;
+	}
+	update->mode = sb.st_mode & 07777;
+
+	char *state_filename = g_strconcat(update->filename, STATE_SUFFIX, NULL);
+	char *contents = NULL;
+	bool ok = g_file_get_contents(state_filename, &contents, NULL, NULL);
+	g_free(state_filename);
+	if (!ok || !g_str_has_prefix(contents, STATE_HEADER)) {
+		g_free(contents);
+		return;
+	}
+
+	char **lines = g_strsplit(contents + strlen(STATE_HEADER), "\n", -1);
+	g_free(contents);
+	if (!lines[0] || !lines[1] || strncmp(lines[0], "R ", 2)
+			|| strcmp(lines[0] + 2, update->request)
+			|| !is_menu_unchanged(lines[1], &sb)
+			|| !g_file_get_contents(update->filename, &update->old_menu,
+				&update->old_len, NULL)) {
+		g_strfreev(lines);
+		return;
+	}
+
+	for (char **line = lines + 2; *line && **line; line++) {
+		struct block block;
+		int n = 0;
+		if (sscanf(*line, "B %" SCNx64 " %zu %zu %n", &block.hash,
+				&block.offset, &block.len, &n) != 3 || !n
+				|| block.offset > update->old_len
+				|| block.len > update->old_len - block.offset) {
+			break;
+		}
+		struct block *copy = g_new(struct block, 1);
+		*copy = block;
+		g_hash_table_replace(update->old_blocks, g_strdup(*line + n), copy);
+	}
+	g_strfreev(lines);
+}
+
+struct menu_update *
+menu_update_begin(const char *filename, const char *request)
+{
+	struct menu_update *update = g_new0(struct menu_update, 1);
+	update->filename = g_strdup(filename);
+	update->request = g_strdup(request);
+	update->mode = 0644;
+	update->old_blocks = g_hash_table_new_full(g_str_hash, g_str_equal,
+		g_free, g_free);
+	update->blocks = g_array_new(FALSE, FALSE, sizeof(struct block));
+	update->ids = g_ptr_array_new_with_free_func(g_free);
+
+	/* A request is written on one line */
+	if (!strchr(request, '\n')) {
+		load_state(update);
+	}
+	return update;
+}
+
+bool
+menu_update_reuse(struct menu_update *update, GString *menu, const char *id,
+		uint64_t hash)
+{
+	struct block *block = g_hash_table_lookup(update->old_blocks, id);
+	if (!block || block->hash != hash) {
+		return false;
+	}
+	size_t offset = menu->len;
+	g_string_append_len(menu, update->old_menu + block->offset, block->len);
+	menu_update_add(update, menu, id, hash, offset);
+	return true;
+}
+
+void
+menu_update_add(struct menu_update *update, GString *menu, const char *id,
+		uint64_t hash, size_t offset)
+{
+	struct block block = { hash, offset, menu->len - offset };
+	g_array_append_val(update->blocks, block);
+	g_ptr_array_add(update->ids, g_strdup(id));
+}
+
+static void
+menu_update_free(struct menu_update *update)
+{
+	g_ptr_array_free(update->ids, TRUE);
+	g_array_free(update->blocks, TRUE);
+	g_hash_table_destroy(update->old_blocks);
+	g_free(update->old_menu);
+	g_free(update->request);
+	g_free(update->filename);
+	g_free(update);
+}
+
+/*
+ * Write the menu next to the old one and rename it into place. A symlinked
+ * menu file is replaced at the target of the link, so the link survives.
+ */
+static bool
+write_menu(struct menu_update *update, GString *menu)
+{
+	char *target = realpath(update->filename, NULL);
+	const char *filename = target ? target : update->filename;
+	char *tmpname = g_strconcat(filename, ".XXXXXX", NULL);
+	bool ok = false;
+	int fd = g_mkstemp(tmpname);
+	if (fd == -1) {
+		fprintf(stderr, "fatal: cannot create '%s': %s\n", tmpname,
+			strerror(errno));
+		goto out;
+	}
+	ok = fchmod(fd, update->mode) == 0
+		&& xml_writev(fd, &(struct iovec){ menu->str, menu->len }, 1);
+	if (close(fd) == -1 || !ok || rename(tmpname, filename) == -1) {
+		fprintf(stderr, "fatal: cannot write '%s': %s\n", filename,
+			strerror(errno));
+		unlink(tmpname);
+		ok = false;
+	}
+out:
+	g_free(tmpname);
+	free(target);
+	return ok;
+}
+
+static void
+write_state(struct menu_update *update)
+{
+	struct stat sb;
+	if (strchr(update->request, '\n') || stat(update->filename, &sb) == -1) {
+		return;
+	}
+	GString *buf = g_string_new(STATE_HEADER);
+	g_string_append_printf(buf, "R %s\n", update->request);
+	g_string_append_printf(buf, "S %ju %jd %jd %ld\n", (uintmax_t)sb.st_ino,
+		(intmax_t)sb.st_size, (intmax_t)sb.st_mtim.tv_sec,
+		(long)sb.st_mtim.tv_nsec);
+	for (guint i = 0; i < update->blocks->len; i++) {
+		struct block *block = &g_array_index(update->blocks,
+			struct block, i);
+		const char *id = g_ptr_array_index(update->ids, i);
+		if (strchr(id, '\n')) {
+			continue;
+		}
+		g_string_append_printf(buf, "B %" PRIx64 " %zu %zu %s\n",
+			block->hash, block->offset, block->len, id);
+	}
+
+	char *state_filename = g_strconcat(update->filename, STATE_SUFFIX, NULL);
+	GError *err = NULL;
+	if (!g_file_set_contents(state_filename, buf->str, buf->len, &err)) {
+		fprintf(stderr, "warn: cannot write menu state: %s\n",
+			err->message);
+		g_error_free(err);
+	}
+	g_free(state_filename);
+	g_string_free(buf, TRUE);
+}
+
+bool
+menu_update_finish(struct menu_update *update, GString *menu)
+{
+	/*
+	 * An unchanged menu is left alone, so that its mtime only changes
+	 * when there is something for the compositor to reload.
+	 */
+	bool ok = true;
+	if (!update->old_menu || update->old_len != menu->len
+			|| memcmp(update->old_menu, menu->str, menu->len)) {
+		ok = write_menu(update, menu);
+		if (ok) {
+			write_state(update);
+		}
+	}
+	menu_update_free(update);
+	return ok;
+}
@@ -0,0 +1,44 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef MENU_UPDATE_H
+#define MENU_UPDATE_H
+#include <glib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Incremental updates of a menu file. Each <menu> block is identified by the
+ * hash of everything rendered into it, and blocks whose hash is unchanged
+ * are copied from the previous menu instead of being rendered again.
+ */
+struct menu_update;
+
+#define MENU_UPDATE_HASH_INIT UINT64_C(14695981039346656037)
+
+/* menu_update_hash - fold @s, which may be NULL, into @hash */
+uint64_t menu_update_hash(uint64_t hash, const char *s);
+
+/*
+ * menu_update_begin - load the state left next to @filename by the last
+ * update with the same @request
+ */
+struct menu_update *menu_update_begin(const char *filename,
+	const char *request);
+
+/*
+ * menu_update_reuse - append the block rendered for menu @id last time if
+ * its hash was @hash. Returns false if it has to be rendered.
+ */
+bool menu_update_reuse(struct menu_update *update, GString *menu,
+	const char *id, uint64_t hash);
+
+/* menu_update_add - record the block for menu @id which starts at @offset */
+void menu_update_add(struct menu_update *update, GString *menu,
+	const char *id, uint64_t hash, size_t offset);
+
+/*
+ * menu_update_finish - replace the menu file with @menu unless it is
+ * unchanged, save the state and free @update. Returns false on error.
+ */
+bool menu_update_finish(struct menu_update *update, GString *menu);
+
+#endif /* MENU_UPDATE_H */
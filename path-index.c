@@ -0,0 +1,318 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Index of the programs in $PATH
+ *
+ * The index file lists the entries of each absolute $PATH directory:
+ *   header:     "LMGPATH <version>\n"
+ *   directory:  "D <mtime> <mtime_nsec> <path>\n"
+ *   entry:      "<name>\n", with an empty line after the last one
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <dirent.h>
+#include <glib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "path-index.h"
+
+#define INDEX_HEADER "LMGPATH 1\n"
+#define INDEX_FILENAME "path-index"
+
+struct path_dir {
+	char *path;
+	int64_t mtime, mtime_nsec;
+	GPtrArray *names;
+};
+
+struct path_index {
+	/* The directories in $PATH order */
+	GPtrArray *path_dirs;
+	/* Maps each program to the first directory which has it */
+	GHashTable *programs;
+	/*
+	 * Relative directories depend on the working directory so are not
+	 * indexed
+	 */
+	bool has_relative_dirs;
+	/* Where to add the directories read when the index is built */
+	GPtrArray *scanned_dirs;
+};
+
+static char *
+index_filename(void)
+{
+	return g_build_filename(g_get_user_cache_dir(), "labwc-menu-generator",
+		INDEX_FILENAME, NULL);
+}
+
+static struct path_dir *
+path_dir_create(const char *path, int64_t mtime, int64_t mtime_nsec)
+{
+	struct path_dir *dir = calloc(1, sizeof(*dir));
+	dir->path = g_strdup(path);
+	dir->mtime = mtime;
+	dir->mtime_nsec = mtime_nsec;
+	dir->names = g_ptr_array_new_with_free_func(g_free);
+	return dir;
+}
+
+static void
+path_dir_free(struct path_dir *dir)
+{
+	g_ptr_array_free(dir->names, TRUE);
+	g_free(dir->path);
+	g_free(dir);
+}
+
+/* Returns a table of the directories listed by a previous run */
+static GHashTable *
+load_index(void)
+{
+	GHashTable *dirs = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+		(GDestroyNotify)path_dir_free);
+	char *filename = index_filename();
+	char *contents = NULL;
+	bool ok = g_file_get_contents(filename, &contents, NULL, NULL);
+	g_free(filename);
+	if (!ok || !g_str_has_prefix(contents, INDEX_HEADER)) {
+		g_free(contents);
+		return dirs;
+	}
+
+	struct path_dir *dir = NULL;
+	char *p = contents + strlen(INDEX_HEADER);
+	char *eol;
+	while ((eol = strchr(p, '\n'))) {
+		*eol = '\0';
+		if (dir && *p) {
+			g_ptr_array_add(dir->names, g_strdup(p));
+		} else if (dir) {
+			dir = NULL;
+		} else {
+			intmax_t mtime, mtime_nsec;
+			int n = 0;
+			if (sscanf(p, "D %jd %jd %n", &mtime, &mtime_nsec, &n) != 2
+					|| !n) {
+				break;
+			}
+			dir = path_dir_create(p + n, mtime, mtime_nsec);
+			g_hash_table_replace(dirs, dir->path, dir);
+		}
+		p = eol + 1;
+	}
+
+	/* A directory without its empty line is incomplete */
+	if (dir) {
+		g_hash_table_remove(dirs, dir->path);
+	}
+	g_free(contents);
+	return dirs;
+}
+
+static void
+write_index(GPtrArray *path_dirs)
+{
+	/*
+	 * A directory modified in the last couple of seconds could be
+	 * modified again without its mtime changing, so is read next time.
+	 */
+	int64_t racy = (int64_t)time(NULL) - 2;
+
+	GString *buf = g_string_new(INDEX_HEADER);
+	for (guint i = 0; i < path_dirs->len; i++) {
+		struct path_dir *dir = g_ptr_array_index(path_dirs, i);
+		if (strchr(dir->path, '\n')) {
+			continue;
+		}
+		bool is_racy = dir->mtime >= racy;
+		g_string_append_printf(buf, "D %jd %jd %s\n",
+			(intmax_t)(is_racy ? -1 : dir->mtime),
+			(intmax_t)(is_racy ? -1 : dir->mtime_nsec), dir->path);
+		for (guint j = 0; j < dir->names->len; j++) {
+			g_string_append_printf(buf, "%s\n",
+				(char *)g_ptr_array_index(dir->names, j));
+		}
+		g_string_append_c(buf, '\n');
+	}
+
+	char *filename = index_filename();
+	char *dirname = g_path_get_dirname(filename);
+	GError *err = NULL;
+	if (g_mkdir_with_parents(dirname, 0700) == -1) {
+		fprintf(stderr, "warn: cannot create directory '%s'\n", dirname);
+	} else if (!g_file_set_contents(filename, buf->str, buf->len, &err)) {
+		fprintf(stderr, "warn: cannot write path index: %s\n",
+			err->message);
+		g_error_free(err);
+	}
+	g_free(dirname);
+	g_free(filename);
+	g_string_free(buf, TRUE);
+}
+
+static struct path_dir *
+read_dir(const char *path, struct stat *sb)
+{
+	DIR *dp = opendir(path);
+	if (!dp) {
+		return NULL;
+	}
+	struct path_dir *dir = path_dir_create(path, sb->st_mtim.tv_sec,
+		sb->st_mtim.tv_nsec);
+	struct dirent *entry;
+	while ((entry = readdir(dp))) {
+		const char *name = entry->d_name;
+		/* Names which do not fit in the index file are not programs */
+		if (!strcmp(name, ".") || !strcmp(name, "..")
+				|| strchr(name, '\n')) {
+			continue;
+		}
+		g_ptr_array_add(dir->names, g_strdup(name));
+	}
+	closedir(dp);
+	return dir;
+}
+
+static bool
+is_indexed(GPtrArray *path_dirs, const char *path)
+{
+	for (guint i = 0; i < path_dirs->len; i++) {
+		struct path_dir *dir = g_ptr_array_index(path_dirs, i);
+		if (!strcmp(dir->path, path)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+struct path_index *
+path_index_create(void)
+{
+	return g_new0(struct path_index, 1);
+}
+
+static void
+path_index_clear(struct path_index *index)
+{
+	if (index->programs) {
+		g_hash_table_destroy(index->programs);
+		index->programs = NULL;
+	}
+	if (index->path_dirs) {
+		g_ptr_array_free(index->path_dirs, TRUE);
+		index->path_dirs = NULL;
+	}
+}
+
+void
+path_index_destroy(struct path_index *index)
+{
+	if (!index) {
+		return;
+	}
+	path_index_clear(index);
+	g_free(index);
+}
+
+void
+path_index_reset(struct path_index *index, GPtrArray *dirs)
+{
+	path_index_clear(index);
+	index->scanned_dirs = dirs;
+}
+
+static void
+path_index_build(struct path_index *index)
+{
+	GPtrArray *dirs = index->scanned_dirs;
+	GPtrArray *path_dirs = g_ptr_array_new_with_free_func(
+		(GDestroyNotify)path_dir_free);
+	GHashTable *programs = g_hash_table_new(g_str_hash, g_str_equal);
+	index->path_dirs = path_dirs;
+	index->programs = programs;
+	index->has_relative_dirs = false;
+
+	GHashTable *cached = load_index();
+	bool dirty = false;
+
+	/* The same default as g_find_program_in_path() */
+	const char *path = g_getenv("PATH");
+	char **elements = g_strsplit(path ? path : "/bin:/usr/bin:.", ":", -1);
+	for (char **p = elements; *p; p++) {
+		if (!g_path_is_absolute(*p)) {
+			index->has_relative_dirs = true;
+			continue;
+		}
+		struct stat sb;
+		if (is_indexed(path_dirs, *p) || stat(*p, &sb) == -1 || !S_ISDIR(sb.st_mode)) {
+			continue;
+		}
+		struct path_dir *dir = g_hash_table_lookup(cached, *p);
+		if (dir && dir->mtime == sb.st_mtim.tv_sec
+				&& dir->mtime_nsec == sb.st_mtim.tv_nsec) {
+			g_hash_table_steal(cached, *p);
+		} else if ((dir = read_dir(*p, &sb))) {
+			dirty = true;
+		} else {
+			continue;
+		}
+		g_ptr_array_add(path_dirs, dir);
+		if (dirs) {
+			g_ptr_array_add(dirs, g_strdup(dir->path));
+		}
+		for (guint i = 0; i < dir->names->len; i++) {
+			char *name = g_ptr_array_index(dir->names, i);
+			if (!g_hash_table_contains(programs, name)) {
+				g_hash_table_insert(programs, name, dir);
+			}
+		}
+	}
+	g_strfreev(elements);
+
+	/* Directories no longer in $PATH also make the index stale */
+	if (dirty || g_hash_table_size(cached)) {
+		write_index(path_dirs);
+	}
+	g_hash_table_destroy(cached);
+}
+
+static bool
+isprog(const char *prog)
+{
+	char *s = g_find_program_in_path(prog);
+	if (!s) {
+		return false;
+	}
+	g_free(s);
+	return true;
+}
+
+bool
+path_index_find(struct path_index *index, const char *prog)
+{
+	if (strchr(prog, '/')) {
+		return isprog(prog);
+	}
+	if (!index->programs) {
+		path_index_build(index);
+	}
+	struct path_dir *dir = g_hash_table_lookup(index->programs, prog);
+	if (!dir) {
+		return index->has_relative_dirs && isprog(prog);
+	}
+
+	/*
+	 * The index only knows about names, so check that the first one in
+	 * $PATH is executable. If not, a later one may be.
+	 */
+	char *filename = g_build_filename(dir->path, prog, NULL);
+	struct stat sb;
+	bool found = stat(filename, &sb) == 0 && !S_ISDIR(sb.st_mode)
+		&& access(filename, X_OK) == 0;
+	g_free(filename);
+	return found || isprog(prog);
+}
@@ -0,0 +1,33 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef PATH_INDEX_H
+#define PATH_INDEX_H
+#include <glib.h>
+#include <stdbool.h>
+
+/*
+ * An index of the programs in the $PATH directories, so that looking up a
+ * program does not take a stat() per directory. Directory listings are kept
+ * in $XDG_CACHE_HOME/labwc-menu-generator/path-index and only read again when
+ * the mtime of a directory changes.
+ */
+
+struct path_index;
+
+struct path_index *path_index_create(void);
+void path_index_destroy(struct path_index *index);
+
+/*
+ * path_index_reset - forget the index, so that it is built for the current
+ * $PATH on the next lookup. The directories it reads then are added to
+ * @dirs, which must outlive the index or the next reset.
+ */
+void path_index_reset(struct path_index *index, GPtrArray *dirs);
+
+/*
+ * path_index_find - return true if @prog is an executable in $PATH, or is
+ * a path to an executable. The first lookup of a program name builds the
+ * index.
+ */
+bool path_index_find(struct path_index *index, const char *prog);
+
+#endif /* PATH_INDEX_H */
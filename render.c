@@ -0,0 +1,530 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Categorize apps into the directories of the schema and render the menu
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <glib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "collate.h"
+#include "desktop.h"
+#include "json-writer.h"
+#include "menu-update.h"
+#include "path-index.h"
+#include "render.h"
+#include "schema.h"
+#include "stats.h"
+#include "xml-writer.h"
+
+G_STATIC_ASSERT(SCHEMA_NR_DIRS <= 64);
+
+static void
+print_app(GString *menu, const struct labwc_menu_options *options,
+		struct app *app)
+{
+	if (options->desktop_filename) {
+		xml_append_literal(menu, "    <!-- ");
+		xml_append_escaped(menu, app->filename);
+		xml_append_literal(menu, " -->\n");
+	}
+
+	xml_append_literal(menu, "    <item label=\"");
+	xml_append_escaped(menu,
+		app->name_localized ? app->name_localized : app->name);
+	xml_append_literal(menu, "\"");
+	if (options->icons && app->icon) {
+		xml_append_literal(menu, " icon=\"");
+		xml_append_escaped(menu, app->icon);
+		xml_append_literal(menu, "\"");
+	}
+	xml_append_literal(menu, ">\n");
+
+	/*
+	 * For Terminal=true entries we prefix the command if the user has
+	 * specified a --terminal-prefix value. Typical values would be 'foot',
+	 * 'alacritty -e' or 'xterm -e'. Many terminals use the -e option, but
+	 * not all.
+	 */
+	xml_append_literal(menu, "      <action name=\"Execute\"><command>");
+	if (app->terminal && options->terminal_prefix) {
+		xml_append_escaped(menu, options->terminal_prefix);
+		xml_append_literal(menu, " '");
+		xml_append_escaped(menu, app->exec);
+		xml_append_literal(menu, "'");
+	} else {
+		xml_append_escaped(menu, app->exec);
+	}
+	xml_append_literal(menu, "</command></action>\n");
+	xml_append_literal(menu, "    </item>\n");
+}
+
+static bool
+is_exec_in_path(struct path_index *path_index, struct app *app)
+{
+	int argc;
+	char **argv;
+	if (!app->exec || !g_shell_parse_argv(app->exec, &argc, &argv, NULL)) {
+		return false;
+	}
+	uint64_t start = stats_begin();
+	bool found = path_index_find(path_index, argv[0]);
+	stats_end(STATS_TRYEXEC, start);
+	g_strfreev(argv);
+	return found;
+}
+
+static bool
+should_not_display(const struct labwc_menu_options *options,
+		struct path_index *path_index, struct app *app)
+{
+	if (app->nodisplay || app->tryexec_not_in_path) {
+		return true;
+	}
+	return options->check_exec && !is_exec_in_path(path_index, app);
+}
+
+/* Everything that print_directory() renders apart from the options */
+static uint64_t
+directory_hash(struct dir *dir, GPtrArray *apps)
+{
+	uint64_t hash = MENU_UPDATE_HASH_INIT;
+	hash = menu_update_hash(hash, dir->name);
+	hash = menu_update_hash(hash, dir->name_localized);
+	hash = menu_update_hash(hash, dir->icon);
+	for (guint i = 0; i < apps->len; i++) {
+		struct app *app = g_ptr_array_index(apps, i);
+		hash = menu_update_hash(hash, app->filename);
+		hash = menu_update_hash(hash, app->name);
+		hash = menu_update_hash(hash, app->name_localized);
+		hash = menu_update_hash(hash, app->icon);
+		hash = menu_update_hash(hash, app->exec);
+		hash = menu_update_hash(hash, app->terminal ? "1" : "0");
+	}
+	return hash;
+}
+
+static void
+print_directory(GString *menu, const struct labwc_menu_options *options,
+		struct menu_update *update, struct dir *dir, GPtrArray *apps)
+{
+	if (!apps->len) {
+		return;
+	}
+
+	uint64_t hash = 0;
+	size_t offset = menu->len;
+	if (update) {
+		hash = directory_hash(dir, apps);
+		if (menu_update_reuse(update, menu, dir->name, hash)) {
+			stats_add(STATS_MENUS_REUSED, 1);
+			return;
+		}
+	}
+
+	xml_append_literal(menu, "  <menu id=\"");
+	xml_append_escaped(menu, dir->name);
+	xml_append_literal(menu, "\" label=\"");
+	xml_append_escaped(menu, dir->name_localized ? : dir->name);
+	xml_append_literal(menu, "\"");
+	if (options->icons && dir->icon) {
+		xml_append_literal(menu, " icon=\"");
+		xml_append_escaped(menu, dir->icon);
+		xml_append_literal(menu, "\"");
+	}
+	xml_append_literal(menu, ">\n");
+
+	for (guint i = 0; i < apps->len; i++) {
+		print_app(menu, options, g_ptr_array_index(apps, i));
+	}
+
+	xml_append_literal(menu, "  </menu> <!-- ");
+	xml_append_escaped(menu, dir->name);
+	xml_append_literal(menu, " -->\n");
+
+	if (update) {
+		menu_update_add(update, menu, dir->name, hash, offset);
+	}
+}
+
+static void
+print_xml(GString *menu, struct menu_model *model, struct menu_update *update)
+{
+	const struct labwc_menu_options *options = model->options;
+	if (!options->bare) {
+		if (options->pipemenu) {
+			xml_append_literal(menu, "<openbox_pipe_menu>\n");
+		} else {
+			xml_append_literal(menu, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+			xml_append_literal(menu, "<openbox_menu>\n");
+			xml_append_literal(menu, "<menu id=\"root-menu\" label=\"root-menu\">\n");
+		}
+	}
+
+	for (guint i = 0; i < model->nr_dirs; i++) {
+		print_directory(menu, options, update, model->dirs[i],
+			model->dir_apps[i]);
+	}
+
+	if (!options->bare) {
+		if (options->pipemenu) {
+			xml_append_literal(menu, "</openbox_pipe_menu>\n");
+		} else {
+			xml_append_literal(menu, "</menu> <!-- root-menu -->\n");
+			xml_append_literal(menu, "</openbox_menu>\n");
+		}
+	}
+}
+
+/*
+ * The fields of a directory, without the braces. The id is also the
+ * untranslated name.
+ */
+static void
+print_json_dir_fields(GString *menu, struct dir *dir)
+{
+	json_append_literal(menu, "\"id\":");
+	json_append_string(menu, dir->name);
+	json_append_literal(menu, ",\"name_localized\":");
+	json_append_string(menu, dir->name_localized);
+	json_append_literal(menu, ",\"icon\":");
+	json_append_string(menu, dir->icon);
+}
+
+/* The fields of an app, without the braces */
+static void
+print_json_app_fields(GString *menu, struct app *app)
+{
+	json_append_literal(menu, "\"filename\":");
+	json_append_string(menu, app->filename);
+	json_append_literal(menu, ",\"name\":");
+	json_append_string(menu, app->name);
+	json_append_literal(menu, ",\"name_localized\":");
+	json_append_string(menu, app->name_localized);
+	json_append_literal(menu, ",\"exec\":");
+	json_append_string(menu, app->exec);
+	json_append_literal(menu, ",\"icon\":");
+	json_append_string(menu, app->icon);
+	json_append_literal(menu, ",\"terminal\":");
+	json_append_bool(menu, app->terminal);
+	json_append_literal(menu, ",\"categories\":");
+	json_append_list(menu, app->categories);
+}
+
+/*
+ * One document holding the directories in menu order, each with its apps
+ * in sort order, like the XML
+ */
+static void
+print_json(GString *menu, struct menu_model *model, struct menu_update *update)
+{
+	/* JSON menus are always rendered in full */
+	(void)update;
+	json_append_literal(menu, "{\"directories\":[");
+	bool first_dir = true;
+	for (guint i = 0; i < model->nr_dirs; i++) {
+		GPtrArray *apps = model->dir_apps[i];
+		if (!apps->len) {
+			continue;
+		}
+		if (!first_dir) {
+			g_string_append_c(menu, ',');
+		}
+		first_dir = false;
+		json_append_literal(menu, "\n{");
+		print_json_dir_fields(menu, model->dirs[i]);
+		json_append_literal(menu, ",\"apps\":[");
+		for (guint j = 0; j < apps->len; j++) {
+			if (j) {
+				g_string_append_c(menu, ',');
+			}
+			json_append_literal(menu, "\n{");
+			print_json_app_fields(menu, g_ptr_array_index(apps, j));
+			g_string_append_c(menu, '}');
+		}
+		json_append_literal(menu, "]}");
+	}
+	json_append_literal(menu, "]}\n");
+}
+
+/*
+ * One line per directory in menu order, then one line per app in sort order
+ * listing the ids of the directories it is in
+ */
+static void
+print_jsonl(GString *menu, struct menu_model *model, struct menu_update *update)
+{
+	/* JSON menus are always rendered in full */
+	(void)update;
+	for (guint i = 0; i < model->nr_dirs; i++) {
+		if (!model->dir_apps[i]->len) {
+			continue;
+		}
+		json_append_literal(menu, "{\"type\":\"directory\",");
+		print_json_dir_fields(menu, model->dirs[i]);
+		json_append_literal(menu, "}\n");
+	}
+	for (guint i = 0; i < model->members->len; i++) {
+		struct member *member = &g_array_index(model->members,
+			struct member, i);
+		json_append_literal(menu, "{\"type\":\"app\",");
+		print_json_app_fields(menu, member->app);
+		json_append_literal(menu, ",\"directories\":[");
+		bool first = true;
+		for (guint j = 0; j < model->nr_dirs; j++) {
+			if (!(member->dir_set & (UINT64_C(1) << j))) {
+				continue;
+			}
+			if (!first) {
+				g_string_append_c(menu, ',');
+			}
+			first = false;
+			json_append_string(menu, model->dirs[j]->name);
+		}
+		json_append_literal(menu, "]}\n");
+	}
+}
+
+/* Indexed by enum labwc_menu_format */
+static const struct {
+	const char *name;
+	/* The character encoding the format in a request, if not xml */
+	char request;
+	void (*print)(GString *menu, struct menu_model *model,
+		struct menu_update *update);
+} formats[] = {
+	{ "xml", 0, print_xml },
+	{ "json", 'j', print_json },
+	{ "jsonl", 'J', print_jsonl },
+};
+
+bool
+render_format_lookup(const char *name, enum labwc_menu_format *format)
+{
+	for (size_t i = 0; i < G_N_ELEMENTS(formats); i++) {
+		if (!strcmp(name, formats[i].name)) {
+			*format = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+unsigned int
+render_fields(const struct labwc_menu_options *options)
+{
+	if (options->format != LABWC_MENU_XML) {
+		return APP_FIELD_FILENAME | APP_FIELD_ICON;
+	}
+	return (options->desktop_filename ? APP_FIELD_FILENAME : 0)
+		| (options->icons ? APP_FIELD_ICON : 0);
+}
+
+struct menu_model *
+menu_model_create(const struct labwc_menu_options *options, GList *dirs,
+		GList *apps, struct path_index *path_index)
+{
+	/*
+	 * Directories in menu order, with any leftover apps going to those
+	 * without categories - the 'Other' directory - which come last.
+	 */
+	struct menu_model *model = g_new0(struct menu_model, 1);
+	guint nr_dirs = g_list_length(dirs);
+	struct dir **order = g_new(struct dir *, nr_dirs);
+	GPtrArray **dir_apps = g_new(GPtrArray *, nr_dirs);
+	GArray *members = g_array_new(FALSE, FALSE, sizeof(struct member));
+	guint nr_categorized = 0;
+	for (GList *iter = dirs; iter; iter = iter->next) {
+		struct dir *dir = (struct dir *)iter->data;
+		if (dir->categories) {
+			order[nr_categorized++] = dir;
+		}
+	}
+	guint n = nr_categorized;
+	for (GList *iter = dirs; iter; iter = iter->next) {
+		struct dir *dir = (struct dir *)iter->data;
+		if (!dir->categories) {
+			order[n++] = dir;
+		}
+	}
+	for (guint i = 0; i < nr_dirs; i++) {
+		dir_apps[i] = g_ptr_array_new();
+	}
+
+	uint64_t start = stats_begin();
+	for (GList *iter = apps; iter; iter = iter->next) {
+		struct app *app = (struct app *)iter->data;
+		if (should_not_display(options, path_index, app)) {
+			continue;
+		}
+		struct member member = { app, 0 };
+		for (guint i = 0; i < nr_categorized; i++) {
+			if (!(app->category_set & order[i]->category_set)) {
+				continue;
+			}
+			g_ptr_array_add(dir_apps[i], app);
+			member.dir_set |= UINT64_C(1) << i;
+			if (options->no_duplicates) {
+				break;
+			}
+		}
+		if (!member.dir_set) {
+			for (guint i = nr_categorized; i < nr_dirs; i++) {
+				g_ptr_array_add(dir_apps[i], app);
+				member.dir_set |= UINT64_C(1) << i;
+			}
+		}
+		g_array_append_val(members, member);
+	}
+	stats_end(STATS_CATEGORIZE, start);
+	for (guint i = 0; i < nr_dirs; i++) {
+		stats_add_menu(order[i]->name, dir_apps[i]->len);
+	}
+
+	model->options = options;
+	model->dirs = order;
+	model->dir_apps = dir_apps;
+	model->nr_dirs = nr_dirs;
+	model->members = members;
+	return model;
+}
+
+void
+menu_model_destroy(struct menu_model *model)
+{
+	for (guint i = 0; i < model->nr_dirs; i++) {
+		g_ptr_array_free(model->dir_apps[i], TRUE);
+	}
+	g_array_free(model->members, TRUE);
+	g_free(model->dir_apps);
+	g_free(model->dirs);
+	g_free(model);
+}
+
+void
+render_menu(GString *menu, struct menu_model *model, struct menu_update *update)
+{
+	uint64_t start = stats_begin();
+	formats[model->options->format].print(menu, model, update);
+	stats_end(STATS_EMIT, start);
+}
+
+static const char *
+get_dir_sort_key(const void *dir)
+{
+	return ((const struct dir *)dir)->sort_key;
+}
+
+GList *
+directory_entries_create(const char *lang)
+{
+	GList *dirs = NULL;
+
+	char name_ll[64], name_llcc[64];
+	lang_name_keys(lang, name_ll, name_llcc);
+	int llcc = schema_locale_lookup(name_llcc);
+	int ll = schema_locale_lookup(name_ll);
+	for (int i = 0; i < SCHEMA_NR_DIRS; i++) {
+		struct dir *dir = calloc(1, sizeof(struct dir));
+		dir->name = schema_dirs[i].name;
+		dir->icon = schema_dirs[i].icon;
+		dir->categories = schema_dirs[i].categories;
+		dir->category_set = schema_dirs[i].category_set;
+		if (llcc >= 0) {
+			dir->name_localized = schema_dir_name_localized(i, llcc);
+		}
+		if (!dir->name_localized && ll >= 0) {
+			dir->name_localized = schema_dir_name_localized(i, ll);
+		}
+		dir->sort_key = collate_key_create(dir->name_localized ?
+			dir->name_localized : dir->name);
+		dirs = g_list_prepend(dirs, dir);
+	}
+	dirs = g_list_reverse(dirs);
+	collate_list_sort(dirs, get_dir_sort_key);
+	return dirs;
+}
+
+void
+directory_entries_destroy(GList *dirs)
+{
+	GList *iter;
+	for (iter = dirs; iter; iter = iter->next) {
+		struct dir *dir = (struct dir *)iter->data;
+		g_free(dir->sort_key);
+		g_free(dir);
+	}
+	g_list_free(dirs);
+}
+
+char *
+render_request_create(const struct labwc_menu_options *options)
+{
+	GString *request = g_string_new(NULL);
+	if (options->bare) {
+		g_string_append_c(request, 'b');
+	}
+	if (options->desktop_filename) {
+		g_string_append_c(request, 'd');
+	}
+	if (options->check_exec) {
+		g_string_append_c(request, 'e');
+	}
+	if (options->icons) {
+		g_string_append_c(request, 'I');
+	}
+	if (options->no_duplicates) {
+		g_string_append_c(request, 'n');
+	}
+	if (options->pipemenu) {
+		g_string_append_c(request, 'p');
+	}
+	if (formats[options->format].request) {
+		g_string_append_c(request, formats[options->format].request);
+	}
+	if (options->terminal_prefix) {
+		g_string_append_printf(request, "t%s", options->terminal_prefix);
+	}
+	return g_string_free(request, FALSE);
+}
+
+void
+render_request_parse(const char *request, struct labwc_menu_options *options)
+{
+	memset(options, 0, sizeof(*options));
+	for (const char *p = request; *p; p++) {
+		switch (*p) {
+		case 'b':
+			options->bare = true;
+			break;
+		case 'd':
+			options->desktop_filename = true;
+			break;
+		case 'e':
+			options->check_exec = true;
+			break;
+		case 'I':
+			options->icons = true;
+			break;
+		case 'n':
+			options->no_duplicates = true;
+			break;
+		case 'p':
+			options->pipemenu = true;
+			break;
+		case 'j':
+			options->format = LABWC_MENU_JSON;
+			break;
+		case 'J':
+			options->format = LABWC_MENU_JSONL;
+			break;
+		case 't':
+			options->terminal_prefix = p + 1;
+			break;
+		}
+		if (options->terminal_prefix) {
+			break;
+		}
+	}
+}
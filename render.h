@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef RENDER_H
+#define RENDER_H
+#include <glib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "labwc-menu.h"
+
+struct menu_update;
+struct path_index;
+
+/* Directory strings point into the tables generated from the schema */
+struct dir {
+	const char *name;
+	const char *name_localized;
+	const char *icon;
+	const char *categories;
+	uint64_t category_set;
+	char *sort_key;
+};
+
+/*
+ * directory_entries_create - the directories of the schema in sort order,
+ * localized for the $LANG value @lang, or that of the process if NULL
+ */
+GList *directory_entries_create(const char *lang);
+void directory_entries_destroy(GList *dirs);
+
+/* The categorized menu which the output formats render */
+struct menu_model {
+	const struct labwc_menu_options *options;
+	/* Directories in menu order and the apps shown in each */
+	struct dir **dirs;
+	GPtrArray **dir_apps;
+	guint nr_dirs;
+	/* The apps shown, in sort order, with a bit per directory they are in */
+	GArray *members;
+};
+
+struct member {
+	struct app *app;
+	uint64_t dir_set;
+};
+
+/*
+ * menu_model_create - put the @apps shown with @options into @dirs
+ * @path_index is what --check-exec looks programs up in.
+ */
+struct menu_model *menu_model_create(const struct labwc_menu_options *options,
+	GList *dirs, GList *apps, struct path_index *path_index);
+void menu_model_destroy(struct menu_model *model);
+
+/*
+ * render_menu - append @model to @menu in the format of its options
+ * Unchanged directories are copied from the previous menu if @update is set.
+ */
+void render_menu(GString *menu, struct menu_model *model,
+	struct menu_update *update);
+
+/*
+ * A request encodes the menu options as their short option characters, with
+ * the terminal prefix last. --format has no short option, so 'j' stands for
+ * json and 'J' for jsonl.
+ */
+char *render_request_create(const struct labwc_menu_options *options);
+
+/* render_request_parse - @options->terminal_prefix points into @request */
+void render_request_parse(const char *request,
+	struct labwc_menu_options *options);
+
+/*
+ * render_fields - the enum app_field bits of the app fields which menus
+ * rendered with @options show
+ */
+unsigned int render_fields(const struct labwc_menu_options *options);
+
+/* render_format_lookup - return false if there is no format called @name */
+bool render_format_lookup(const char *name, enum labwc_menu_format *format);
+
+#endif /* RENDER_H */
@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Per-phase timings and counters
+ *
+ * The read and parse phases run in the worker threads, so their times are
+ * summed over threads and can add up to more than the wall time.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <glib.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <time.h>
+#include "json-writer.h"
+#include "stats.h"
+
+static const char *phase_names[STATS_NR_PHASES] = {
+	[STATS_I18N_INIT] = "i18n_init",
+	[STATS_REPLAY] = "replay",
+	[STATS_TRAVERSE] = "traverse",
+	[STATS_READ] = "read",
+	[STATS_PARSE] = "parse",
+	[STATS_TRYEXEC] = "tryexec",
+	[STATS_SORT] = "sort",
+	[STATS_DIRECTORIES] = "directories",
+	[STATS_CATEGORIZE] = "categorize",
+	[STATS_EMIT] = "emit",
+};
+
+static const char *counter_names[STATS_NR_COUNTERS] = {
+	[STATS_DIRS_VISITED] = "dirs_visited",
+	[STATS_FILES_SEEN] = "files_seen",
+	[STATS_FILES_PARSED] = "files_parsed",
+	[STATS_FILES_CACHED] = "files_cached",
+	[STATS_FILES_IGNORED] = "files_ignored",
+	[STATS_FILES_DUPLICATE] = "files_duplicate",
+	[STATS_FILES_INVALID] = "files_invalid",
+	[STATS_BYTES_READ] = "bytes_read",
+	[STATS_LINES_PARSED] = "lines_parsed",
+	[STATS_MENUS_REUSED] = "menus_reused",
+};
+
+struct menu_stats {
+	const char *name;
+	unsigned int nr_apps;
+};
+
+static bool enabled;
+static _Atomic uint64_t phases[STATS_NR_PHASES];
+static _Atomic uint64_t counters[STATS_NR_COUNTERS];
+static GArray *menus;
+
+static uint64_t
+now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+void
+stats_enable(void)
+{
+	enabled = true;
+	menus = g_array_new(FALSE, FALSE, sizeof(struct menu_stats));
+}
+
+uint64_t
+stats_begin(void)
+{
+	return enabled ? now_ns() : 0;
+}
+
+void
+stats_end(enum stats_phase phase, uint64_t start)
+{
+	if (enabled) {
+		atomic_fetch_add_explicit(&phases[phase], now_ns() - start,
+			memory_order_relaxed);
+	}
+}
+
+void
+stats_add(enum stats_counter counter, uint64_t n)
+{
+	if (enabled) {
+		atomic_fetch_add_explicit(&counters[counter], n,
+			memory_order_relaxed);
+	}
+}
+
+void
+stats_add_menu(const char *name, unsigned int nr_apps)
+{
+	if (enabled) {
+		struct menu_stats menu = { name, nr_apps };
+		g_array_append_val(menus, menu);
+	}
+}
+
+/* Menu names come from the schema, but are escaped all the same */
+static void
+print_json(void)
+{
+	GString *buf = g_string_new(NULL);
+	json_append_literal(buf, "{\"phases_ms\":{");
+	for (int i = 0; i < STATS_NR_PHASES; i++) {
+		g_string_append_printf(buf, "%s\"%s\":%.3f", i ? "," : "",
+			phase_names[i], phases[i] / 1e6);
+	}
+	json_append_literal(buf, "},\"counters\":{");
+	for (int i = 0; i < STATS_NR_COUNTERS; i++) {
+		g_string_append_printf(buf, "%s\"%s\":%ju", i ? "," : "",
+			counter_names[i], (uintmax_t)counters[i]);
+	}
+	json_append_literal(buf, "},\"menus\":{");
+	for (guint i = 0; i < menus->len; i++) {
+		struct menu_stats *menu = &g_array_index(menus, struct menu_stats, i);
+		if (i) {
+			g_string_append_c(buf, ',');
+		}
+		json_append_string(buf, menu->name);
+		g_string_append_printf(buf, ":%u", menu->nr_apps);
+	}
+	json_append_literal(buf, "}}\n");
+	fputs(buf->str, stderr);
+	g_string_free(buf, TRUE);
+}
+
+static void
+print_text(void)
+{
+	for (int i = 0; i < STATS_NR_PHASES; i++) {
+		fprintf(stderr, "%-16s %10.3f ms\n", phase_names[i],
+			phases[i] / 1e6);
+	}
+	for (int i = 0; i < STATS_NR_COUNTERS; i++) {
+		fprintf(stderr, "%-16s %10ju\n", counter_names[i],
+			(uintmax_t)counters[i]);
+	}
+	for (guint i = 0; i < menus->len; i++) {
+		struct menu_stats *menu = &g_array_index(menus, struct menu_stats, i);
+		fprintf(stderr, "menu %-11s %10u apps\n", menu->name,
+			menu->nr_apps);
+	}
+}
+
+void
+stats_print(bool json)
+{
+	if (!enabled) {
+		return;
+	}
+	if (json) {
+		print_json();
+	} else {
+		print_text();
+	}
+	g_array_free(menus, TRUE);
+	menus = NULL;
+	enabled = false;
+}
@@ -0,0 +1,56 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef STATS_H
+#define STATS_H
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Timings and counters for --stats. Everything is a no-op until
+ * stats_enable() is called, and counters may be updated from any thread.
+ */
+
+enum stats_phase {
+	STATS_I18N_INIT = 0,
+	STATS_REPLAY,
+	STATS_TRAVERSE,
+	STATS_READ,
+	STATS_PARSE,
+	STATS_TRYEXEC,
+	STATS_SORT,
+	STATS_DIRECTORIES,
+	STATS_CATEGORIZE,
+	STATS_EMIT,
+	STATS_NR_PHASES,
+};
+
+enum stats_counter {
+	STATS_DIRS_VISITED = 0,
+	STATS_FILES_SEEN,
+	STATS_FILES_PARSED,
+	STATS_FILES_CACHED,
+	STATS_FILES_IGNORED,
+	STATS_FILES_DUPLICATE,
+	STATS_FILES_INVALID,
+	STATS_BYTES_READ,
+	STATS_LINES_PARSED,
+	STATS_MENUS_REUSED,
+	STATS_NR_COUNTERS,
+};
+
+void stats_enable(void);
+
+/* stats_begin - return the start time of a phase, or 0 if disabled */
+uint64_t stats_begin(void);
+
+/* stats_end - add the time since @start to @phase */
+void stats_end(enum stats_phase phase, uint64_t start);
+
+void stats_add(enum stats_counter counter, uint64_t n);
+
+/* stats_add_menu - record that @nr_apps were emitted in menu @name */
+void stats_add_menu(const char *name, unsigned int nr_apps);
+
+/* stats_print - write the report to stderr as text or as a JSON object */
+void stats_print(bool json);
+
+#endif /* STATS_H */
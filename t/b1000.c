@@ -0,0 +1,89 @@
+/*
+ * b1000 - parse .desktop files with many translations
+ *
+ * Writes NR_FILES .desktop files with NR_LOCALES translations of Name,
+ * GenericName, Comment and Keywords, then reports how many lines per second
+ * labwc-menu-generator parses with the parse cache removed before each run.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define NR_FILES 1000
+#define NR_LOCALES 150
+#define NR_RUNS 5
+
+static const char *translated_keys[] = {
+	"Name", "GenericName", "Comment", "Keywords", NULL
+};
+
+static long
+write_corpus(const char *dir)
+{
+	char path[256];
+	long nr_lines = 0;
+	for (int i = 0; i < NR_FILES; i++) {
+		snprintf(path, sizeof(path), "%s/app-%04d.desktop", dir, i);
+		FILE *f = fopen(path, "w");
+		if (!f) {
+			perror(path);
+			exit(1);
+		}
+		fprintf(f, "[Desktop Entry]\nType=Application\n");
+		fprintf(f, "Name=App %d\nExec=app-%d %%U\nIcon=app-%d\n", i, i, i);
+		fprintf(f, "Categories=Utility;\nTerminal=false\n");
+		nr_lines += 7;
+		for (const char **key = translated_keys; *key; key++) {
+			for (int j = 0; j < NR_LOCALES; j++) {
+				fprintf(f, "%s[l%c%c_C%c]=Translation %d of app %d\n",
+					*key, 'a' + j % 26, 'a' + j / 26 % 26,
+					'A' + j % 26, j, i);
+				nr_lines++;
+			}
+		}
+		fprintf(f, "\n[Desktop Action new]\nName=New\nExec=app-%d --new\n", i);
+		fclose(f);
+	}
+	return nr_lines;
+}
+
+static double
+now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(void)
+{
+	(void)system("rm -rf /tmp/b1000");
+	mkdir("/tmp/b1000", 0755);
+	mkdir("/tmp/b1000/applications", 0755);
+	long nr_lines = write_corpus("/tmp/b1000/applications");
+
+	setenv("XDG_DATA_HOME", "/tmp/b1000", 1);
+	setenv("XDG_DATA_DIRS", "bad-location", 1);
+	setenv("XDG_CACHE_HOME", "/tmp/b1000/cache", 1);
+	setenv("LABWC_MENU_GENERATOR_DEBUG_FIRST_DIR_ONLY", "1", 1);
+	setenv("LANG", "sv_SE.UTF-8", 1);
+	setenv("LC_ALL", "C", 1);
+
+	double best = 0;
+	for (int i = 0; i < NR_RUNS; i++) {
+		(void)system("rm -rf /tmp/b1000/cache");
+		double start = now();
+		(void)system("./labwc-menu-generator -j 1 >/dev/null");
+		double elapsed = now() - start;
+		if (!i || elapsed < best) {
+			best = elapsed;
+		}
+	}
+	printf("%ld lines in %.3f s, %.0f lines/s\n", nr_lines, best,
+		nr_lines / best);
+
+	(void)system("rm -rf /tmp/b1000");
+	return 0;
+}
@@ -0,0 +1,91 @@
+/*
+ * b1001 - scale to <n> .desktop files
+ *
+ * Generates a corpus of <n> files spread over several XDG data directories
+ * and reports the wall time, files per second and peak RSS of
+ * labwc-menu-generator with a cold cache, with a warm parse cache, and
+ * when the menu is replayed from the menu cache.
+ */
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include <fcntl.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "corpus.h"
+
+extern char **environ;
+
+static double
+now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void
+run(const char *label, unsigned int nr_files)
+{
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null",
+		O_WRONLY, 0);
+	char *argv[] = { "./labwc-menu-generator", NULL };
+
+	double start = now();
+	pid_t pid;
+	if (posix_spawn(&pid, argv[0], &actions, NULL, argv, environ)) {
+		perror(argv[0]);
+		exit(1);
+	}
+	int status;
+	struct rusage usage;
+	wait4(pid, &status, 0, &usage);
+	double elapsed = now() - start;
+	posix_spawn_file_actions_destroy(&actions);
+
+	printf("%-7s %7u files %8.3f s %10.0f files/s %8ld KiB peak RSS\n",
+		label, nr_files, elapsed, nr_files / elapsed, usage.ru_maxrss);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int nr_files = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000;
+	char root[64], cache[80];
+	snprintf(root, sizeof(root), "/tmp/b1001-%u", nr_files);
+	snprintf(cache, sizeof(cache), "%s/cache", root);
+
+	struct corpus_options options;
+	corpus_options_init(&options, root, nr_files);
+	char *data_dirs;
+	unsigned int nr_written = corpus_write(&options, &data_dirs);
+
+	setenv("XDG_DATA_HOME", "/nonexistent", 1);
+	setenv("XDG_DATA_DIRS", data_dirs, 1);
+	setenv("XDG_CACHE_HOME", cache, 1);
+	setenv("LANG", "de_DE.UTF-8", 1);
+	setenv("LC_ALL", "C", 1);
+	unsetenv("LABWC_MENU_GENERATOR_DEBUG_FIRST_DIR_ONLY");
+
+	char cmd[256];
+	snprintf(cmd, sizeof(cmd), "rm -rf %s", cache);
+	(void)system(cmd);
+	run("cold", nr_written);
+
+	snprintf(cmd, sizeof(cmd), "rm -f %s/labwc-menu-generator/menu-*", cache);
+	(void)system(cmd);
+	run("warm", nr_written);
+
+	run("replay", nr_written);
+
+	snprintf(cmd, sizeof(cmd), "rm -rf %s", root);
+	(void)system(cmd);
+	free(data_dirs);
+	return 0;
+}
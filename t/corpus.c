@@ -0,0 +1,453 @@
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <libgen.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "corpus.h"
+
+static const char *languages[] = {
+	"af", "am", "ar", "ast", "be", "bg", "bn", "br", "bs", "ca", "cs", "cy",
+	"da", "de", "el", "eo", "es", "et", "eu", "fa", "fi", "fr", "ga", "gl",
+	"he", "hi", "hr", "hu", "id", "is", "it", "ja", "ka", "kk", "km", "kn",
+	"ko", "lt", "lv", "mk", "ml", "mr", "ms", "nb", "nl", "nn", "oc", "pa",
+	"pl", "pt", "ro", "ru", "sk", "sl", "sq", "sr", "sv", "ta", "te", "th",
+	"tr", "ug", "uk", "uz", "vi", "zh",
+};
+
+static const char *countries[] = {
+	"", "_GB", "_BR", "_CN", "_TW", "_HK", "_AU", "_CA", "_IN", "@latin",
+};
+
+static const char *translated_keys[] = {
+	"Name", "GenericName", "Comment", "Keywords",
+};
+
+static const char *categories[] = {
+	"Utility;", "Development;IDE;", "Game;ArcadeGame;",
+	"Graphics;2DGraphics;", "AudioVideo;Audio;Player;",
+	"Network;WebBrowser;", "Office;WordProcessor;",
+	"Settings;DesktopSettings;", "System;TerminalEmulator;",
+	"Education;Science;", "X-Vendor-Specific;",
+};
+
+static const char filler[] =
+	" lorem ipsum dolor sit amet consectetur adipiscing elit sed do"
+	" eiusmod tempor incididunt ut labore et dolore magna aliqua";
+
+#define LENGTH(a) (sizeof(a) / sizeof((a)[0]))
+
+struct profile {
+	const char *name;
+	/* Data directories relative to the root, highest precedence first */
+	const char *prefixes[3];
+	/* Format of any further data directories, given their index */
+	const char *extra_prefix;
+	unsigned int symlink_rate;
+	unsigned int nested_rate;
+};
+
+static const struct profile profiles[] = {
+	[CORPUS_GENERIC] = {
+		.name = "generic",
+		.extra_prefix = "prefix%u",
+		.nested_rate = 20,
+	},
+	[CORPUS_DEBIAN] = {
+		.name = "debian",
+		.prefixes = { "usr/local/share", "usr/share" },
+		.extra_prefix = "opt/vendor%u/share",
+		.symlink_rate = 2,
+		.nested_rate = 5,
+	},
+	/* Exports link to the active deployment of each app */
+	[CORPUS_FLATPAK] = {
+		.name = "flatpak",
+		.prefixes = {
+			"home/.local/share/flatpak/exports/share",
+			"var/lib/flatpak/exports/share",
+		},
+		.extra_prefix = "var/lib/flatpak-%u/exports/share",
+		.symlink_rate = 100,
+	},
+	[CORPUS_SNAP] = {
+		.name = "snap",
+		.prefixes = { "var/lib/snapd/desktop", "usr/share" },
+		.extra_prefix = "opt/snap%u/share",
+	},
+	/* Profiles link to the files in the store */
+	[CORPUS_NIX] = {
+		.name = "nix",
+		.prefixes = {
+			"home/.nix-profile/share",
+			"nix/var/nix/profiles/default/share",
+			"run/current-system/sw/share",
+		},
+		.extra_prefix = "etc/profiles/per-user/user%u/share",
+		.symlink_rate = 100,
+	},
+};
+
+static uint32_t state;
+
+/* xorshift32, so that the tree only depends on the seed */
+static uint32_t
+next(void)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+static unsigned int
+range(unsigned int min, unsigned int max)
+{
+	return max > min ? min + next() % (max - min + 1) : min;
+}
+
+static bool
+chance(unsigned int percent)
+{
+	return next() % 100 < percent;
+}
+
+static void
+mkdir_p(const char *path)
+{
+	char buf[4096];
+	snprintf(buf, sizeof(buf), "%s", path);
+	for (char *p = buf + 1; *p; p++) {
+		if (*p == '/') {
+			*p = '\0';
+			mkdir(buf, 0755);
+			*p = '/';
+		}
+	}
+	if (mkdir(buf, 0755) == -1 && errno != EEXIST) {
+		perror(buf);
+		exit(1);
+	}
+}
+
+static void
+write_locale(FILE *f, unsigned int i)
+{
+	const char *language = languages[i % LENGTH(languages)];
+	const char *country = countries[i / LENGTH(languages) % LENGTH(countries)];
+	fprintf(f, "%s%s", language, country);
+}
+
+/* Mostly short lines with a long tail, like real translations */
+static unsigned int
+line_length(const struct corpus_options *options)
+{
+	unsigned int min = options->min_line_length;
+	unsigned int max = options->max_line_length;
+	if (max <= min) {
+		return min;
+	}
+	double u = next() % 1001 / 1000.0;
+	return min + (unsigned int)((max - min) * u * u * u);
+}
+
+/* Writes @value and fills it up to a length from line_length() */
+static void
+write_value(FILE *f, const char *value, bool is_invalid,
+		const struct corpus_options *options)
+{
+	/* A truncated two-byte sequence followed by a byte never in UTF-8 */
+	if (is_invalid) {
+		fputs("\xc3(\xff ", f);
+	}
+	fputs(value, f);
+	unsigned int len = strlen(value) + (is_invalid ? 4 : 0);
+	unsigned int target = line_length(options);
+	for (unsigned int i = 0; len < target; i++, len++) {
+		fputc(filler[i % (sizeof(filler) - 1)], f);
+	}
+	fputc('\n', f);
+}
+
+/* The desktop file ID of file @n, less the .desktop suffix */
+static void
+app_id(char *buf, size_t size, enum corpus_profile profile, unsigned int n)
+{
+	switch (profile) {
+	case CORPUS_FLATPAK:
+		snprintf(buf, size, "org.example.App%05u", n);
+		break;
+	case CORPUS_SNAP:
+		snprintf(buf, size, "app%05u_app%05u", n, n);
+		break;
+	default:
+		snprintf(buf, size, "app%05u", n);
+		break;
+	}
+}
+
+/* A store path like /nix/store/<hash>-app00001-1.0, the same for each @n */
+static void
+nix_store_path(char *buf, size_t size, unsigned int n)
+{
+	static const char digits[] = "0123456789abcdfghijklmnpqrsvwxyz";
+	char hash[33];
+	uint32_t x = n * 2654435761u + 1;
+	for (int i = 0; i < 32; i++) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		hash[i] = digits[x % 32];
+	}
+	hash[32] = '\0';
+	snprintf(buf, size, "nix/store/%s-app%05u-1.0", hash, n);
+}
+
+static void
+write_exec(FILE *f, unsigned int n, const char *id, enum corpus_profile profile)
+{
+	char store[128];
+	switch (profile) {
+	case CORPUS_FLATPAK:
+		fprintf(f, "Exec=/usr/bin/flatpak run --branch=stable --arch=x86_64"
+			" --command=app%u --file-forwarding %s @@u %%U @@\n", n, id);
+		fprintf(f, "X-Flatpak=%s\n", id);
+		break;
+	case CORPUS_SNAP:
+		fprintf(f, "Exec=env BAMF_DESKTOP_FILE_HINT=/var/lib/snapd/desktop/"
+			"applications/%s.desktop /snap/bin/app%05u %%U\n", id, n);
+		fprintf(f, "X-SnapInstanceName=app%05u\n", n);
+		break;
+	case CORPUS_NIX:
+		nix_store_path(store, sizeof(store), n);
+		fprintf(f, "Exec=/%s/bin/app%u %%U\n", store, n);
+		break;
+	default:
+		fprintf(f, "Exec=app%u %%U\n", n);
+		break;
+	}
+}
+
+static void
+write_entry(FILE *f, unsigned int n, const char *id,
+		const struct corpus_options *options)
+{
+	unsigned int nr = range(options->min_translations,
+		options->max_translations);
+	/* The translation with invalid UTF-8 in it, or none */
+	unsigned int invalid = chance(options->invalid_utf8_rate)
+		? next() % (nr + 1) : nr + 1;
+
+	fprintf(f, "[Desktop Entry]\n");
+	fprintf(f, "Type=Application\n");
+	fprintf(f, "Version=1.0\n");
+	fprintf(f, "Name=Application %u\n", n);
+	fprintf(f, "GenericName=Generic application\n");
+	char value[256];
+	snprintf(value, sizeof(value), "Does application number %u things", n);
+	fprintf(f, "Comment=");
+	write_value(f, value, invalid == nr, options);
+	write_exec(f, n, id, options->profile);
+	if (chance(25)) {
+		fprintf(f, chance(50) ? "TryExec=sh\n" : "TryExec=no-such-app%u\n", n);
+	}
+	fprintf(f, "Icon=app%u\n", n);
+	fprintf(f, "Terminal=%s\n", chance(10) ? "true" : "false");
+	if (chance(5)) {
+		fprintf(f, "NoDisplay=true\n");
+	}
+	fprintf(f, "Categories=%s\n", categories[next() % LENGTH(categories)]);
+	fprintf(f, "StartupNotify=true\n");
+
+	for (unsigned int i = 0; i < nr; i++) {
+		const char *key = translated_keys[i % LENGTH(translated_keys)];
+		fprintf(f, "%s[", key);
+		write_locale(f, i / LENGTH(translated_keys));
+		fprintf(f, "]=");
+		snprintf(value, sizeof(value), "Translated %s of application %u",
+			key, n);
+		write_value(f, value, invalid == i, options);
+	}
+
+	unsigned int nr_actions = chance(30) ? range(1, 3) : 0;
+	for (unsigned int i = 0; i < nr_actions; i++) {
+		fprintf(f, "\n[Desktop Action action%u]\n", i);
+		fprintf(f, "Name=Action %u\n", i);
+		for (unsigned int j = 0; j < 10; j++) {
+			fprintf(f, "Name[");
+			write_locale(f, j);
+			fprintf(f, "]=Translated action %u\n", i);
+		}
+		fprintf(f, "Exec=app%u --action%u\n", n, i);
+	}
+}
+
+static void
+write_file(const char *path, const char *buf, size_t len)
+{
+	FILE *f = fopen(path, "w");
+	if (!f || fwrite(buf, 1, len, f) != len || fclose(f)) {
+		perror(path);
+		exit(1);
+	}
+}
+
+/* Where a symlinked file @id of file @n points to */
+static void
+store_path(char *buf, size_t size, const struct corpus_options *options,
+		unsigned int n, const char *id)
+{
+	char store[128];
+	switch (options->profile) {
+	case CORPUS_FLATPAK:
+		snprintf(buf, size, "%s/var/lib/flatpak/app/%s/x86_64/stable/active"
+			"/export/share/applications/%s.desktop", options->root, id, id);
+		break;
+	case CORPUS_SNAP:
+		snprintf(buf, size, "%s/snap/app%05u/current/meta/gui/%s.desktop",
+			options->root, n, id);
+		break;
+	case CORPUS_NIX:
+		nix_store_path(store, sizeof(store), n);
+		snprintf(buf, size, "%s/%s/share/applications/%s.desktop",
+			options->root, store, id);
+		break;
+	default:
+		snprintf(buf, size, "%s/store/%s.desktop", options->root, id);
+		break;
+	}
+}
+
+static void
+prefix_path(char *buf, size_t size, const struct corpus_options *options,
+		unsigned int p)
+{
+	const struct profile *profile = &profiles[options->profile];
+	int len = snprintf(buf, size, "%s/", options->root);
+	if (p < LENGTH(profile->prefixes) && profile->prefixes[p]) {
+		snprintf(buf + len, size - len, "%s", profile->prefixes[p]);
+	} else {
+		snprintf(buf + len, size - len, profile->extra_prefix, p);
+	}
+}
+
+void
+corpus_options_init(struct corpus_options *options, const char *root,
+		unsigned int nr_files)
+{
+	memset(options, 0, sizeof(*options));
+	options->root = root;
+	options->profile = CORPUS_GENERIC;
+	options->seed = 1;
+	options->nr_files = nr_files;
+	options->nr_prefixes = 3;
+	options->min_translations = 50;
+	options->max_translations = 150;
+	options->duplicate_rate = 10;
+	options->nested_rate = profiles[CORPUS_GENERIC].nested_rate;
+	options->nesting_depth = 1;
+	options->symlink_rate = profiles[CORPUS_GENERIC].symlink_rate;
+}
+
+bool
+corpus_profile_set(struct corpus_options *options, const char *name)
+{
+	for (unsigned int i = 0; i < LENGTH(profiles); i++) {
+		if (!strcmp(profiles[i].name, name)) {
+			options->profile = i;
+			options->symlink_rate = profiles[i].symlink_rate;
+			options->nested_rate = profiles[i].nested_rate;
+			return true;
+		}
+	}
+	return false;
+}
+
+unsigned int
+corpus_write(const struct corpus_options *options, char **data_dirs)
+{
+	char cmd[4096];
+	snprintf(cmd, sizeof(cmd), "rm -rf '%s'", options->root);
+	(void)system(cmd);
+
+	state = options->seed ? options->seed : 1;
+	unsigned int nr_prefixes = options->nr_prefixes ? options->nr_prefixes : 1;
+	size_t dirs_len = 0;
+	*data_dirs = calloc(1, 1);
+	for (unsigned int p = 0; p < nr_prefixes; p++) {
+		char dir[4096];
+		prefix_path(dir, sizeof(dir) - strlen("/applications"), options, p);
+		dirs_len += strlen(dir) + 1;
+		*data_dirs = realloc(*data_dirs, dirs_len + 1);
+		if (p) {
+			strcat(*data_dirs, ":");
+		}
+		strcat(*data_dirs, dir);
+		strcat(dir, "/applications");
+		mkdir_p(dir);
+	}
+
+	unsigned int nr_written = 0;
+	for (unsigned int n = 0; n < options->nr_files; n++) {
+		char id[64];
+		app_id(id, sizeof(id), options->profile, n);
+		char *buf = NULL;
+		size_t len = 0;
+		FILE *f = open_memstream(&buf, &len);
+		write_entry(f, n, id, options);
+		fclose(f);
+
+		/* Subdirectories give desktop file IDs like vendor3-app00001.desktop */
+		char subdir[256] = "";
+		if (chance(options->nested_rate)) {
+			unsigned int depth = range(1, options->nesting_depth);
+			int sublen = snprintf(subdir, sizeof(subdir), "/vendor%u", n % 8);
+			for (unsigned int i = 1; i < depth && sublen < 200; i++) {
+				sublen += snprintf(subdir + sublen, sizeof(subdir) - sublen,
+					"/sub%u", i);
+			}
+		}
+
+		/* Copies of a symlinked file all point to the same target */
+		char target[4096] = "";
+		if (chance(options->symlink_rate)) {
+			store_path(target, sizeof(target), options, n, id);
+			char *dir = strdup(target);
+			mkdir_p(dirname(dir));
+			free(dir);
+			write_file(target, buf, len);
+		}
+
+		unsigned int p = n % nr_prefixes;
+		unsigned int copies = chance(options->duplicate_rate) ? 2 : 1;
+		for (unsigned int i = 0; i < copies && i < nr_prefixes; i++) {
+			char dir[4096], path[8192];
+			prefix_path(dir, sizeof(dir) - sizeof(subdir) - 16, options,
+				(p + i) % nr_prefixes);
+			strcat(dir, "/applications");
+			strcat(dir, subdir);
+			mkdir_p(dir);
+			snprintf(path, sizeof(path), "%s/%s.desktop", dir, id);
+			if (!*target) {
+				write_file(path, buf, len);
+			} else if (symlink(target, path) == -1) {
+				perror(path);
+				exit(1);
+			}
+			nr_written++;
+		}
+		free(buf);
+	}
+
+	/*
+	 * Recent mtimes make caches distrust the files, so the tree is dated
+	 * well in the past, which also makes it the same on every run.
+	 */
+	snprintf(cmd, sizeof(cmd),
+		"find '%s' -exec touch -h -d @1600000000 {} +", options->root);
+	(void)system(cmd);
+	return nr_written;
+}
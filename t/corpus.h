@@ -0,0 +1,65 @@
+#ifndef CORPUS_H
+#define CORPUS_H
+#include <stdbool.h>
+
+/* Where the data directories are and how the files are named and linked */
+enum corpus_profile {
+	CORPUS_GENERIC = 0,
+	CORPUS_DEBIAN,
+	CORPUS_FLATPAK,
+	CORPUS_SNAP,
+	CORPUS_NIX,
+};
+
+/*
+ * Synthetic trees of .desktop files for benchmarks. The same options and
+ * seed always give the same tree.
+ */
+struct corpus_options {
+	/* Directory holding one XDG data directory per prefix */
+	const char *root;
+	enum corpus_profile profile;
+	unsigned int seed;
+	unsigned int nr_files;
+	/* Number of XDG data directories */
+	unsigned int nr_prefixes;
+	/* Localized keys per file */
+	unsigned int min_translations;
+	unsigned int max_translations;
+	/*
+	 * Length of the values of Comment and the localized keys, mostly
+	 * near the minimum. Zero leaves them unpadded.
+	 */
+	unsigned int min_line_length;
+	unsigned int max_line_length;
+	/* Percentage of files which are also in the next prefix */
+	unsigned int duplicate_rate;
+	/* Percentage of files in a vendor subdirectory */
+	unsigned int nested_rate;
+	/* Deepest vendor subdirectory */
+	unsigned int nesting_depth;
+	/* Percentage of files with a localized value which is not UTF-8 */
+	unsigned int invalid_utf8_rate;
+	/* Percentage of files which are symlinks into a store outside the prefixes */
+	unsigned int symlink_rate;
+};
+
+/* corpus_options_init - the shape of a typical desktop */
+void corpus_options_init(struct corpus_options *options, const char *root,
+	unsigned int nr_files);
+
+/*
+ * corpus_profile_set - use @profile and its usual symlink and nesting rates.
+ * Returns false if there is no profile called @name.
+ */
+bool corpus_profile_set(struct corpus_options *options, const char *name);
+
+/*
+ * corpus_write - replace @options->root with a new tree. Returns the number
+ * of files written and sets *@data_dirs to a malloc'ed value for
+ * $XDG_DATA_DIRS, highest precedence first.
+ */
+unsigned int corpus_write(const struct corpus_options *options,
+	char **data_dirs);
+
+#endif /* CORPUS_H */
@@ -0,0 +1,160 @@
+/*
+ * gen-corpus - write a tree of .desktop files for stress and scaling tests
+ *
+ * The tree depends only on the options, so a tree which is slow or breaks
+ * labwc-menu-generator can be reproduced from its command line. The value
+ * for $XDG_DATA_DIRS is printed on stdout.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "corpus.h"
+
+static const struct option long_options[] = {
+	{"depth", required_argument, NULL, 'd'},
+	{"duplicates", required_argument, NULL, 'D'},
+	{"fan-out", required_argument, NULL, 'f'},
+	{"files", required_argument, NULL, 'n'},
+	{"help", no_argument, NULL, 'h'},
+	{"invalid-utf8", required_argument, NULL, 'u'},
+	{"line-length", required_argument, NULL, 'l'},
+	{"nested", required_argument, NULL, 'N'},
+	{"profile", required_argument, NULL, 'p'},
+	{"seed", required_argument, NULL, 's'},
+	{"symlinks", required_argument, NULL, 'S'},
+	{"translations", required_argument, NULL, 't'},
+	{0, 0, 0, 0}
+};
+
+static const char gen_corpus_usage[] =
+"Usage: gen-corpus [options...] <root>\n"
+"  -d, --depth <n>          Nest vendor subdirectories up to <n> deep (1)\n"
+"  -D, --duplicates <pct>   Also put <pct>% of files in the next prefix (10)\n"
+"  -f, --fan-out <n>        Spread files over <n> XDG data directories (3)\n"
+"  -h, --help               Show help message and quit\n"
+"  -l, --line-length <min>[-<max>]\n"
+"                           Pad localized values to <min>-<max> bytes\n"
+"  -n, --files <n>          Write <n> .desktop files (1000)\n"
+"  -N, --nested <pct>       Put <pct>% of files in vendor subdirectories\n"
+"  -p, --profile <name>     generic, debian, flatpak, snap or nix (generic)\n"
+"  -s, --seed <n>           Seed the generator with <n> (1)\n"
+"  -S, --symlinks <pct>     Make <pct>% of files symlinks into a store\n"
+"  -t, --translations <min>[-<max>]\n"
+"                           Write <min>-<max> localized keys per file (50-150)\n"
+"  -u, --invalid-utf8 <pct> Put invalid UTF-8 in <pct>% of files (0)\n";
+
+static void
+usage(void)
+{
+	printf("%s", gen_corpus_usage);
+	exit(0);
+}
+
+static unsigned int
+parse_number(const char *s)
+{
+	char *end;
+	unsigned long n = strtoul(s, &end, 10);
+	if (end == s || *end) {
+		fprintf(stderr, "fatal: bad number '%s'\n", s);
+		exit(1);
+	}
+	return n;
+}
+
+static void
+parse_range(const char *s, unsigned int *min, unsigned int *max)
+{
+	char *end;
+	*min = strtoul(s, &end, 10);
+	*max = *min;
+	if (*end == '-') {
+		*max = parse_number(end + 1);
+	} else if (end == s || *end) {
+		fprintf(stderr, "fatal: bad range '%s'\n", s);
+		exit(1);
+	}
+}
+
+int
+main(int argc, char **argv)
+{
+	struct corpus_options options;
+	corpus_options_init(&options, NULL, 1000);
+
+	/* The profile sets defaults for some of the other options */
+	const char *profile = NULL;
+	const char *nested_rate = NULL, *symlink_rate = NULL;
+	int c;
+	while (1) {
+		int index = 0;
+		c = getopt_long(argc, argv, "d:D:f:hl:n:N:p:s:S:t:u:", long_options,
+			&index);
+		if (c == -1) {
+			break;
+		}
+		switch (c) {
+		case 'd':
+			options.nesting_depth = parse_number(optarg);
+			break;
+		case 'D':
+			options.duplicate_rate = parse_number(optarg);
+			break;
+		case 'f':
+			options.nr_prefixes = parse_number(optarg);
+			break;
+		case 'l':
+			parse_range(optarg, &options.min_line_length,
+				&options.max_line_length);
+			break;
+		case 'n':
+			options.nr_files = parse_number(optarg);
+			break;
+		case 'N':
+			nested_rate = optarg;
+			break;
+		case 'p':
+			profile = optarg;
+			break;
+		case 's':
+			options.seed = parse_number(optarg);
+			break;
+		case 'S':
+			symlink_rate = optarg;
+			break;
+		case 't':
+			parse_range(optarg, &options.min_translations,
+				&options.max_translations);
+			break;
+		case 'u':
+			options.invalid_utf8_rate = parse_number(optarg);
+			break;
+		case 'h':
+		default:
+			usage();
+		}
+	}
+	if (optind != argc - 1) {
+		usage();
+	}
+	options.root = argv[optind];
+	if (profile && !corpus_profile_set(&options, profile)) {
+		fprintf(stderr, "fatal: no profile '%s'\n", profile);
+		exit(1);
+	}
+	if (nested_rate) {
+		options.nested_rate = parse_number(nested_rate);
+	}
+	if (symlink_rate) {
+		options.symlink_rate = parse_number(symlink_rate);
+	}
+
+	char *data_dirs;
+	unsigned int nr_written = corpus_write(&options, &data_dirs);
+	printf("%s\n", data_dirs);
+	fprintf(stderr, "%u files\n", nr_written);
+	free(data_dirs);
+	return 0;
+}
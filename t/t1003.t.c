@@ -17,14 +17,18 @@ int main(void)
 	diag("t1003.t - survive bad .desktop files");
 	setenv("XDG_DATA_HOME", "../t/t1003", 1);
 	setenv("XDG_DATA_DIRS", "bad-location", 1);
+	setenv("XDG_CACHE_HOME", "/tmp/t1003-cache", 1);
 	setenv("LABWC_MENU_GENERATOR_DEBUG_FIRST_DIR_ONLY", "1", 1);
 	setenv("LANG", "C", 1);
+	setenv("LC_ALL", "C", 1);
+	(void)system("rm -rf /tmp/t1003-cache");
 	char command[1000];
 	snprintf(command, sizeof(command), "./labwc-menu-generator -I >%s", actual);
 	(void)system(command);
 	bool pass = test_cmp_files(actual, expect);
 	if (pass) {
 		unlink(actual);
+		(void)system("rm -rf /tmp/t1003-cache");
 	}
 	return exit_status();
 }
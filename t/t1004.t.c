@@ -0,0 +1,54 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "tap.h"
+#include "test-lib.h"
+
+int main(void)
+{
+	char actual[] = "/tmp/t1004-actual";
+	char expect[] = "../t/t1000/menu.xml";
+
+	plan(4);
+
+	diag("t1004.t - parse and menu caches do not change the output");
+	setenv("XDG_DATA_HOME", "../t/t1000", 1);
+	setenv("XDG_DATA_DIRS", "bad-location", 1);
+	setenv("XDG_CACHE_HOME", "/tmp/t1004-cache", 1);
+	setenv("LABWC_MENU_GENERATOR_DEBUG_FIRST_DIR_ONLY", "1", 1);
+	setenv("LANG", "C", 1);
+	setenv("LC_ALL", "C", 1);
+	(void)system("rm -rf /tmp/t1004-cache");
+	char command[1000];
+	snprintf(command, sizeof(command), "./labwc-menu-generator -I >%s", actual);
+
+	/* test 1 */
+	(void)system(command);
+	bool pass = test_cmp_files(actual, expect);
+
+	/* test 2 */
+	(void)system("rm -f /tmp/t1004-cache/labwc-menu-generator/menu-*");
+	(void)system(command);
+	pass &= test_cmp_files(actual, expect);
+
+	/* test 3 */
+	(void)system(command);
+	pass &= test_cmp_files(actual, expect);
+
+	/* test 4 - storing a menu evicts the oldest beyond 32 */
+	(void)system("cd /tmp/t1004-cache/labwc-menu-generator && "
+		"for i in $(seq 10 49); do "
+		"touch -d 2020-01-01T00:$i menu-$(printf %064d $i); done");
+	(void)system("./labwc-menu-generator -b >/dev/null");
+	pass &= ok1(system("cd /tmp/t1004-cache/labwc-menu-generator && "
+		"test $(ls menu-* | wc -l) = 32 && "
+		"test ! -e menu-$(printf %064d 10)") == 0);
+
+	if (pass) {
+		unlink(actual);
+		(void)system("rm -rf /tmp/t1004-cache");
+	}
+	return exit_status();
+}
@@ -0,0 +1,35 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "tap.h"
+#include "test-lib.h"
+
+int main(void)
+{
+	char actual[] = "/tmp/t1005-actual";
+	char expect[] = "../t/t1005/menu.xml";
+
+	plan(1);
+
+	/* test 1 */
+	diag("t1005.t - lines without newline, of any length and other groups");
+	setenv("XDG_DATA_HOME", "../t/t1005", 1);
+	setenv("XDG_DATA_DIRS", "bad-location", 1);
+	setenv("XDG_CACHE_HOME", "/tmp/t1005-cache", 1);
+	setenv("LABWC_MENU_GENERATOR_DEBUG_FIRST_DIR_ONLY", "1", 1);
+	setenv("LANG", "C", 1);
+	setenv("LC_ALL", "C", 1);
+	(void)system("rm -rf /tmp/t1005-cache");
+	char command[1000];
+	snprintf(command, sizeof(command), "./labwc-menu-generator >%s", actual);
+	(void)system(command);
+	bool pass = test_cmp_files(actual, expect);
+	if (pass) {
+		unlink(actual);
+		(void)system("rm -rf /tmp/t1005-cache");
+	}
+	return exit_status();
+}
+
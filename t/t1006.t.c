@@ -0,0 +1,56 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "tap.h"
+#include "test-lib.h"
+
+int main(void)
+{
+	char actual[] = "/tmp/t1006-actual";
+	char expect[] = "../t/t1006/menu.xml";
+
+	plan(3);
+
+	/* test 1 */
+	diag("t1006.t - desktop file IDs of regular files shadow lower precedence dirs");
+	setenv("XDG_DATA_HOME", "../t/t1006/home:../t/t1006/system", 1);
+	setenv("XDG_DATA_DIRS", "bad-location", 1);
+	setenv("XDG_CACHE_HOME", "/tmp/t1006-cache", 1);
+	setenv("LABWC_MENU_GENERATOR_DEBUG_FIRST_DIR_ONLY", "1", 1);
+	setenv("LANG", "C", 1);
+	setenv("LC_ALL", "C", 1);
+	(void)system("rm -rf /tmp/t1006-cache");
+	char command[1000];
+	snprintf(command, sizeof(command), "./labwc-menu-generator >%s", actual);
+	(void)system(command);
+	bool pass = test_cmp_files(actual, expect);
+
+	/*
+	 * test 2 - a copy with old mtimes, so that both caches are written,
+	 * gives the same menu
+	 */
+	setenv("XDG_DATA_HOME",
+		"/tmp/t1006-data/home:/tmp/t1006-data/system", 1);
+	(void)system("rm -rf /tmp/t1006-cache /tmp/t1006-data");
+	(void)system("cp -R ../t/t1006 /tmp/t1006-data && "
+		"find /tmp/t1006-data -exec touch -h -d 2020-01-01 {} +");
+	(void)system(command);
+	pass &= test_cmp_files(actual, expect);
+
+	/* test 3 - the target of the dangling symlink appears */
+	(void)system("mkdir /tmp/t1006-data/nonexistent && "
+		"printf '[Desktop Entry]\\nName=stale (home)\\nExec=stale\\n' "
+		">/tmp/t1006-data/nonexistent/stale.desktop");
+	(void)system(command);
+	pass &= ok1(test_file_contains(actual, "label=\"stale (home)\"")
+		&& !test_file_contains(actual, "label=\"stale (system)\""));
+
+	if (pass) {
+		unlink(actual);
+		(void)system("rm -rf /tmp/t1006-cache /tmp/t1006-data");
+	}
+	return exit_status();
+}
+
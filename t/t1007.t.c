@@ -0,0 +1,56 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "tap.h"
+#include "test-lib.h"
+
+int main(void)
+{
+	char actual[] = "/tmp/t1007-actual";
+	char expect[] = "../t/t1007/menu.xml";
+
+	plan(3);
+
+	diag("t1007.t - TryExec= and --check-exec with a cold and warm path index");
+	setenv("XDG_DATA_HOME", "../t/t1007", 1);
+	setenv("XDG_DATA_DIRS", "bad-location", 1);
+	setenv("XDG_CACHE_HOME", "/tmp/t1007-cache", 1);
+	setenv("LABWC_MENU_GENERATOR_DEBUG_FIRST_DIR_ONLY", "1", 1);
+	setenv("LANG", "C", 1);
+	setenv("LC_ALL", "C", 1);
+
+	/* Only absolute $PATH directories are indexed */
+	char path[4096];
+	if (!getcwd(path, sizeof(path) - 32)) {
+		return 1;
+	}
+	strcat(path, "/../t/t1007/bin:/usr/bin:/bin");
+	setenv("PATH", path, 1);
+
+	(void)system("rm -rf /tmp/t1007-cache");
+	char command[1000];
+	snprintf(command, sizeof(command), "./labwc-menu-generator -e >%s", actual);
+
+	/* test 1 */
+	(void)system(command);
+	bool pass = test_cmp_files(actual, expect);
+
+	/* test 2 */
+	(void)system("rm -f /tmp/t1007-cache/labwc-menu-generator/menu-*");
+	(void)system(command);
+	pass &= test_cmp_files(actual, expect);
+
+	/* test 3 - $PATH is not read for a menu which does not need it */
+	pass &= ok1(system("rm -rf /tmp/t1007-cache && "
+		"XDG_DATA_HOME=../t/t1000 ./labwc-menu-generator >/dev/null && "
+		"test ! -e /tmp/t1007-cache/labwc-menu-generator/path-index") == 0);
+
+	if (pass) {
+		unlink(actual);
+		(void)system("rm -rf /tmp/t1007-cache");
+	}
+	return exit_status();
+}
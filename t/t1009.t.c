@@ -0,0 +1,55 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "tap.h"
+#include "test-lib.h"
+
+int main(void)
+{
+	char actual[] = "/tmp/t1009-actual";
+	char expect[] = "../t/t1000/menu.xml";
+	char stats[] = "/tmp/t1009-stats";
+
+	plan(4);
+
+	diag("t1009.t - --stats reports to stderr and leaves the menu alone");
+	setenv("XDG_DATA_HOME", "../t/t1000", 1);
+	setenv("XDG_DATA_DIRS", "bad-location", 1);
+	setenv("XDG_CACHE_HOME", "/tmp/t1009-cache", 1);
+	setenv("LABWC_MENU_GENERATOR_DEBUG_FIRST_DIR_ONLY", "1", 1);
+	setenv("LANG", "C", 1);
+	setenv("LC_ALL", "C", 1);
+
+	(void)system("rm -rf /tmp/t1009-cache");
+	char command[1000];
+	snprintf(command, sizeof(command),
+		"./labwc-menu-generator -I --stats=json >%s 2>%s", actual, stats);
+
+	/* test 1 */
+	(void)system(command);
+	bool pass = test_cmp_files(actual, expect);
+
+	/* test 2 */
+	pass &= ok1(test_file_contains(stats, "\"files_cached\":0,")
+		&& test_file_contains(stats, "\"menus\":{\""));
+
+	/* test 3 */
+	(void)system("rm -f /tmp/t1009-cache/labwc-menu-generator/menu-*");
+	(void)system(command);
+	pass &= ok1(test_file_contains(stats, "\"files_parsed\":0,"));
+
+	/* test 4 */
+	snprintf(command, sizeof(command), "./labwc-menu-generator "
+		"--format=jsonl --stats=json >/dev/null 2>%s", stats);
+	(void)system(command);
+	pass &= ok1(test_file_contains(stats, "\"System\":17"));
+
+	if (pass) {
+		unlink(actual);
+		unlink(stats);
+		(void)system("rm -rf /tmp/t1009-cache");
+	}
+	return exit_status();
+}
@@ -0,0 +1,46 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "tap.h"
+#include "test-lib.h"
+
+int main(void)
+{
+	char actual[] = "/tmp/t1010-actual";
+	char expect[] = "../t/t1000/menu.xml";
+	char trace[] = "/tmp/t1010-trace.json";
+
+	plan(2);
+
+	diag("t1010.t - $LABWC_MENU_GENERATOR_TRACE writes a trace of the run");
+	setenv("XDG_DATA_HOME", "../t/t1000", 1);
+	setenv("XDG_DATA_DIRS", "bad-location", 1);
+	setenv("XDG_CACHE_HOME", "/tmp/t1010-cache", 1);
+	setenv("LABWC_MENU_GENERATOR_DEBUG_FIRST_DIR_ONLY", "1", 1);
+	setenv("LABWC_MENU_GENERATOR_TRACE", trace, 1);
+	setenv("LANG", "C", 1);
+	setenv("LC_ALL", "C", 1);
+
+	(void)system("rm -rf /tmp/t1010-cache");
+	char command[1000];
+	snprintf(command, sizeof(command), "./labwc-menu-generator -I >%s",
+		actual);
+
+	/* test 1 */
+	(void)system(command);
+	bool pass = test_cmp_files(actual, expect);
+
+	/* test 2 */
+	pass &= ok1(test_file_contains(trace, "\"name\":\"desktop_entries_create\"")
+		&& test_file_contains(trace, "\"cat\":\"dir\"")
+		&& test_file_contains(trace, "\"cat\":\"parse\""));
+
+	if (pass) {
+		unlink(actual);
+		unlink(trace);
+		(void)system("rm -rf /tmp/t1010-cache");
+	}
+	return exit_status();
+}
@@ -0,0 +1,72 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "tap.h"
+#include "test-lib.h"
+
+int main(void)
+{
+	char actual[] = "/tmp/t1011-menu.xml";
+	char expect[] = "../t/t1000/menu.xml";
+	char stats[] = "/tmp/t1011-stats";
+	char link[] = "/tmp/t1011-link.xml";
+
+	plan(7);
+
+	diag("t1011.t - --update writes the menu file and reuses unchanged blocks");
+	setenv("XDG_DATA_HOME", "../t/t1000", 1);
+	setenv("XDG_DATA_DIRS", "bad-location", 1);
+	setenv("XDG_CACHE_HOME", "/tmp/t1011-cache", 1);
+	setenv("LABWC_MENU_GENERATOR_DEBUG_FIRST_DIR_ONLY", "1", 1);
+	setenv("LANG", "C", 1);
+	setenv("LC_ALL", "C", 1);
+
+	(void)system("rm -rf /tmp/t1011-cache /tmp/t1011-menu.xml* "
+		"/tmp/t1011-link.xml*");
+	char command[1000];
+	snprintf(command, sizeof(command),
+		"./labwc-menu-generator -I --update %s", actual);
+
+	/* test 1 */
+	(void)system(command);
+	bool pass = test_cmp_files(actual, expect);
+
+	/* test 2 */
+	snprintf(command, sizeof(command),
+		"./labwc-menu-generator -I --stats=json --update %s 2>%s",
+		actual, stats);
+	(void)system(command);
+	pass &= test_cmp_files(actual, expect);
+
+	/* test 3 - every menu is copied from the previous run */
+	pass &= ok1(test_file_contains(stats, "\"menus_reused\":8}"));
+
+	/* test 4 - the state does not apply to a menu changed since */
+	snprintf(command, sizeof(command),
+		"echo '<!-- edited -->' >>%s && "
+		"./labwc-menu-generator -I --stats=json --update %s 2>%s",
+		actual, actual, stats);
+	(void)system(command);
+	pass &= test_cmp_files(actual, expect);
+
+	/* test 5 */
+	pass &= ok1(test_file_contains(stats, "\"menus_reused\":0}"));
+
+	/* test 6 - a symlinked menu file is written through the link */
+	snprintf(command, sizeof(command),
+		"ln -s %s %s && echo '<!-- edited -->' >>%s && "
+		"./labwc-menu-generator -I --update %s && test -L %s",
+		actual, link, actual, link, link);
+	pass &= ok1(system(command) == 0);
+
+	/* test 7 */
+	pass &= test_cmp_files(actual, expect);
+
+	if (pass) {
+		(void)system("rm -rf /tmp/t1011-cache /tmp/t1011-menu.xml* "
+			"/tmp/t1011-link.xml*");
+	}
+	return exit_status();
+}
@@ -0,0 +1,43 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "tap.h"
+#include "test-lib.h"
+
+int main(void)
+{
+	char actual[] = "/tmp/t1012-menu.xml";
+	char expect[] = "../t/t1000/menu.xml";
+
+	plan(2);
+
+	diag("t1012.t - --batch writes each menu of the manifest from one scan");
+	setenv("XDG_DATA_HOME", "../t/t1000", 1);
+	setenv("XDG_DATA_DIRS", "bad-location", 1);
+	setenv("XDG_CACHE_HOME", "/tmp/t1012-cache", 1);
+	setenv("LABWC_MENU_GENERATOR_DEBUG_FIRST_DIR_ONLY", "1", 1);
+	setenv("LANG", "C", 1);
+	setenv("LC_ALL", "C", 1);
+
+	(void)system("rm -rf /tmp/t1012-*");
+	(void)system("echo '# menus' >/tmp/t1012-manifest && "
+		"echo '/tmp/t1012-menu.xml -I' >>/tmp/t1012-manifest && "
+		"echo \"/tmp/t1012-de.xml LANG=de_DE -t 'xterm -e'\" "
+		">>/tmp/t1012-manifest");
+	(void)system("./labwc-menu-generator --batch /tmp/t1012-manifest");
+
+	/* test 1 */
+	bool pass = test_cmp_files(actual, expect);
+
+	/* test 2 - another language is localized from the same scan */
+	(void)system("LANG=de_DE XDG_CACHE_HOME=/tmp/t1012-cache-de "
+		"./labwc-menu-generator -t 'xterm -e' >/tmp/t1012-expect-de.xml");
+	pass &= test_cmp_files("/tmp/t1012-de.xml", "/tmp/t1012-expect-de.xml");
+
+	if (pass) {
+		(void)system("rm -rf /tmp/t1012-*");
+	}
+	return exit_status();
+}
@@ -0,0 +1,62 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "tap.h"
+#include "test-lib.h"
+
+int main(void)
+{
+	char json[] = "/tmp/t1013-json";
+	char jsonl[] = "/tmp/t1013-jsonl";
+
+	plan(3);
+
+	diag("t1013.t - --format=json and jsonl serialize the same menu");
+	setenv("XDG_DATA_HOME", "../t/t1000", 1);
+	setenv("XDG_DATA_DIRS", "bad-location", 1);
+	setenv("XDG_CACHE_HOME", "/tmp/t1013-cache", 1);
+	setenv("LABWC_MENU_GENERATOR_DEBUG_FIRST_DIR_ONLY", "1", 1);
+	setenv("LANG", "C", 1);
+	setenv("LC_ALL", "C", 1);
+
+	(void)system("rm -rf /tmp/t1013-cache /tmp/t1013-data");
+	char command[1000];
+	snprintf(command, sizeof(command),
+		"./labwc-menu-generator --format=json >%s && "
+		"./labwc-menu-generator --format=jsonl >%s", json, jsonl);
+	(void)system(command);
+
+	/* test 1 */
+	bool pass = ok1(test_file_contains(json, "{\"directories\":[\n"
+		"{\"id\":\"Accessories\",\"name_localized\":null,"
+		"\"icon\":\"applications-accessories\",\"apps\":[\n")
+		&& test_file_contains(json, "\"terminal\":true,"
+		"\"categories\":[\"Utility\",\"TextEditor\"]}]},\n"));
+
+	/* test 2 */
+	pass &= ok1(test_file_contains(jsonl, "{\"type\":\"app\","
+		"\"filename\":\"vim.desktop\",\"name\":\"Vim\","
+		"\"name_localized\":null,\"exec\":\"vim\",\"icon\":\"gvim\","
+		"\"terminal\":true,\"categories\":[\"Utility\",\"TextEditor\"],"
+		"\"directories\":[\"Accessories\"]}\n"));
+
+	/* test 3 - filenames which are not UTF-8 are made valid */
+	snprintf(command, sizeof(command),
+		"mkdir -p /tmp/t1013-data/applications && "
+		"printf '[Desktop Entry]\\nName=ab\\nExec=ab\\n' "
+		">\"/tmp/t1013-data/applications/a$(printf '\\377')b.desktop\" && "
+		"XDG_DATA_HOME=/tmp/t1013-data ./labwc-menu-generator "
+		"--format=jsonl >%s", jsonl);
+	(void)system(command);
+	pass &= ok1(test_file_contains(jsonl,
+		"\"filename\":\"a\xef\xbf\xbd" "b.desktop\""));
+
+	if (pass) {
+		unlink(json);
+		unlink(jsonl);
+		(void)system("rm -rf /tmp/t1013-cache /tmp/t1013-data");
+	}
+	return exit_status();
+}
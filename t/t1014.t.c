@@ -0,0 +1,65 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "labwc-menu.h"
+#include "tap.h"
+#include "test-lib.h"
+
+int main(void)
+{
+	char actual[] = "/tmp/t1014-actual";
+	char expect[] = "../t/t1000/menu.xml";
+
+	plan(3);
+
+	diag("t1014.t - liblabwc-menu renders the same menu in-process");
+	setenv("XDG_DATA_HOME", "../t/t1000", 1);
+	setenv("XDG_DATA_DIRS", "bad-location", 1);
+	setenv("XDG_CACHE_HOME", "/tmp/t1014-cache", 1);
+	setenv("LABWC_MENU_GENERATOR_DEBUG_FIRST_DIR_ONLY", "1", 1);
+	setenv("LANG", "C", 1);
+	setenv("LC_ALL", "C", 1);
+	(void)system("rm -rf /tmp/t1014-cache");
+
+	struct labwc_menu *menu = labwc_menu_create();
+	labwc_menu_scan(menu);
+	struct labwc_menu_options options = { .icons = true };
+
+	/* test 1 */
+	size_t len = labwc_menu_render(menu, &options, NULL, 0);
+	char *buf = malloc(len + 1);
+	labwc_menu_render(menu, &options, buf, len + 1);
+	FILE *fp = fopen(actual, "w");
+	fwrite(buf, 1, len, fp);
+	fclose(fp);
+	bool pass = test_cmp_files(actual, expect);
+
+	/* test 2 */
+	char small[16];
+	pass &= ok1(labwc_menu_render(menu, &options, small, sizeof(small)) == len
+		&& strlen(small) == sizeof(small) - 1
+		&& !strncmp(small, buf, sizeof(small) - 1));
+
+	/* test 3 */
+	size_t nr_dirs, nr_apps;
+	const struct labwc_menu_dir *dirs = labwc_menu_dirs(menu, &nr_dirs);
+	const struct labwc_menu_app *apps = labwc_menu_dir_apps(menu, &options,
+		"Accessories", &nr_apps);
+	bool found = false;
+	for (size_t i = 0; i < nr_apps; i++) {
+		found |= !strcmp(apps[i].filename, "vim.desktop")
+			&& apps[i].terminal && !strcmp(apps[i].exec, "vim");
+	}
+	pass &= ok1(nr_dirs && !strcmp(dirs[0].id, "Accessories") && found);
+
+	free(buf);
+	labwc_menu_destroy(menu);
+	if (pass) {
+		unlink(actual);
+		(void)system("rm -rf /tmp/t1014-cache");
+	}
+	return exit_status();
+}
@@ -0,0 +1,75 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "tap.h"
+#include "test-lib.h"
+
+static bool
+is_shown(const char *filename, const char *menu)
+{
+	char command[1000];
+	snprintf(command, sizeof(command), "grep -q -F '<!-- %s -->' %s",
+		filename, menu);
+	return system(command) == 0;
+}
+
+int main(void)
+{
+	char actual[] = "/tmp/t1015-actual";
+	char ignore[] = "/tmp/t1015-ignore";
+
+	plan(4);
+
+	diag("t1015.t - --ignore takes names, globs and Exec/Categories lines");
+	setenv("XDG_DATA_HOME", "../t/t1000", 1);
+	setenv("XDG_DATA_DIRS", "bad-location", 1);
+	setenv("XDG_CACHE_HOME", "/tmp/t1015-cache", 1);
+	setenv("LABWC_MENU_GENERATOR_DEBUG_FIRST_DIR_ONLY", "1", 1);
+	setenv("LANG", "C", 1);
+	setenv("LC_ALL", "C", 1);
+	(void)system("rm -rf /tmp/t1015-cache");
+
+	FILE *fp = fopen(ignore, "w");
+	fprintf(fp, "# managed list\n\n"
+		"vim.desktop\n"
+		"org.gtk.*\n"
+		"*-settings.desktop\n"
+		"urxvt?.desktop\n"
+		"Exec=xterm\n"
+		"Categories=Audio*\n");
+	fclose(fp);
+	char command[1000];
+	snprintf(command, sizeof(command),
+		"./labwc-menu-generator -d -i %s >%s", ignore, actual);
+	(void)system(command);
+
+	/* test 1 */
+	bool pass = ok1(!is_shown("vim.desktop", actual)
+		&& is_shown("leafpad.desktop", actual));
+
+	/* test 2 */
+	pass &= ok1(!is_shown("org.gtk.Demo4.desktop", actual)
+		&& !is_shown("org.xfce.mousepad-settings.desktop", actual)
+		&& !is_shown("urxvtc.desktop", actual)
+		&& is_shown("urxvt.desktop", actual)
+		&& is_shown("org.xfce.mousepad.desktop", actual));
+
+	/* test 3 */
+	pass &= ok1(!is_shown("xterm.desktop", actual)
+		&& is_shown("uxterm.desktop", actual)
+		&& !is_shown("audacious.desktop", actual));
+
+	/* test 4 */
+	(void)system(command);
+	pass &= ok1(!is_shown("vim.desktop", actual)
+		&& !is_shown("xterm.desktop", actual));
+
+	if (pass) {
+		unlink(actual);
+		unlink(ignore);
+		(void)system("rm -rf /tmp/t1015-cache");
+	}
+	return exit_status();
+}
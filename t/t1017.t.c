@@ -0,0 +1,51 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "tap.h"
+#include "test-lib.h"
+
+int main(void)
+{
+	char actual[] = "/tmp/t1017-actual";
+	char expect[] = "../t/t1000/menu.xml";
+
+	plan(3);
+
+	diag("t1017.t - files edited in place are not served from the menu cache");
+	setenv("XDG_DATA_HOME", "/tmp/t1017-data", 1);
+	setenv("XDG_DATA_DIRS", "bad-location", 1);
+	setenv("XDG_CACHE_HOME", "/tmp/t1017-cache", 1);
+	setenv("LABWC_MENU_GENERATOR_DEBUG_FIRST_DIR_ONLY", "1", 1);
+	setenv("LANG", "C", 1);
+	setenv("LC_ALL", "C", 1);
+	(void)system("rm -rf /tmp/t1017-cache /tmp/t1017-data");
+
+	/* Menus made from files modified just now are not cached */
+	(void)system("cp -R ../t/t1000 /tmp/t1017-data && "
+		"find /tmp/t1017-data -exec touch -d 2020-01-01 {} +");
+	char command[1000];
+	snprintf(command, sizeof(command), "./labwc-menu-generator -I >%s", actual);
+
+	/* test 1 */
+	(void)system(command);
+	bool pass = test_cmp_files(actual, expect);
+
+	/* test 2 */
+	(void)system(command);
+	pass &= test_cmp_files(actual, expect);
+
+	/* test 3 - rewriting the file leaves the mtime of its directory alone */
+	(void)system("printf '[Desktop Entry]\\nName=Edited\\nExec=leafpad\\n"
+		"Categories=Utility;\\n' "
+		">/tmp/t1017-data/applications/leafpad.desktop");
+	(void)system(command);
+	pass &= ok1(test_file_contains(actual, "label=\"Edited\""));
+
+	if (pass) {
+		unlink(actual);
+		(void)system("rm -rf /tmp/t1017-cache /tmp/t1017-data");
+	}
+	return exit_status();
+}
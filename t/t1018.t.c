@@ -0,0 +1,68 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "tap.h"
+#include "test-lib.h"
+
+int main(void)
+{
+	char actual[] = "/tmp/t1018-actual";
+	char expect[] = "/tmp/t1018-expect";
+	char empty[] = "/dev/null";
+
+	plan(3);
+
+	diag("t1018.t - --connect gets the menu from a running --daemon");
+	setenv("XDG_DATA_HOME", "/tmp/t1018-data", 1);
+	setenv("XDG_DATA_DIRS", "bad-location", 1);
+	setenv("XDG_CACHE_HOME", "/tmp/t1018-cache", 1);
+	setenv("XDG_RUNTIME_DIR", "/tmp/t1018-run", 1);
+	setenv("LABWC_MENU_GENERATOR_DEBUG_FIRST_DIR_ONLY", "1", 1);
+	setenv("LANG", "C", 1);
+	setenv("LC_ALL", "C", 1);
+
+	(void)system("rm -rf /tmp/t1018-*");
+	(void)system("mkdir -p /tmp/t1018-data && mkdir -m 700 /tmp/t1018-run");
+
+	/*
+	 * Clients which generate the menu themselves write to their cache
+	 * directory, so the daemon has answered if there is none. The socket
+	 * is there a little before the daemon listens on it.
+	 */
+	(void)system("./labwc-menu-generator --daemon >/dev/null 2>&1 & "
+		"echo $! >/tmp/t1018-pid; for i in $(seq 50); do "
+		"rm -rf /tmp/t1018-probe; "
+		"XDG_CACHE_HOME=/tmp/t1018-probe ./labwc-menu-generator "
+		"--connect >/dev/null; test -e /tmp/t1018-probe || break; "
+		"sleep 0.1; done");
+
+	char command[1000];
+	snprintf(command, sizeof(command),
+		"XDG_CACHE_HOME=/tmp/t1018-client ./labwc-menu-generator "
+		"--connect -b -I >%s && test ! -e /tmp/t1018-client", actual);
+
+	/* test 1 - an empty menu is a reply too */
+	bool pass = ok1(system(command) == 0);
+
+	/* test 2 */
+	pass &= test_cmp_files(actual, empty);
+
+	/* test 3 - the applications directory is noticed when it appears */
+	(void)system("touch /tmp/t1018-data/unrelated && "
+		"mkdir /tmp/t1018-data/applications && "
+		"cp ../t/t1000/applications/*.desktop /tmp/t1018-data/applications");
+	(void)system(command);
+	snprintf(command, sizeof(command),
+		"XDG_CACHE_HOME=/tmp/t1018-client ./labwc-menu-generator -b -I >%s",
+		expect);
+	(void)system(command);
+	pass &= test_cmp_files(actual, expect);
+
+	(void)system("kill $(cat /tmp/t1018-pid)");
+	if (pass) {
+		(void)system("rm -rf /tmp/t1018-*");
+	}
+	return exit_status();
+}
@@ -2,6 +2,7 @@
 #include <glib.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdarg.h>
 #include <ctype.h>
 #include <unistd.h>
@@ -42,3 +43,14 @@ test_cmp_files(const char *filename_actual, const char *filename_expect)
 	return is_equal;
 }
 
+bool
+test_file_contains(const char *filename, const char *needle)
+{
+	gchar *data = NULL;
+	if (!g_file_get_contents(filename, &data, NULL, NULL)) {
+		return false;
+	}
+	bool found = strstr(data, needle);
+	g_free(data);
+	return found;
+}
@@ -2,5 +2,6 @@
 #define TEST_LIB_H
 
 bool test_cmp_files(const char *filename_actual, const char *filename_expect);
+bool test_file_contains(const char *filename, const char *needle);
 
 #endif /* TEST_LIB_H */
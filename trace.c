@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Trace events for a single run
+ *
+ * Complete ("X") events are appended to a buffer under a lock and written
+ * out in one go at the end, so tracing does no I/O while it runs. The
+ * thread calling trace_init() is thread 1 and the others are numbered in
+ * the order in which they record their first span.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <glib.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "json-writer.h"
+#include "trace.h"
+
+static char *filename;
+static GString *events;
+static GMutex lock;
+static uint64_t epoch;
+static atomic_int nr_threads;
+static _Thread_local int thread_id;
+
+static uint64_t
+now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* Called with the lock held, or before there are other threads */
+static int
+get_thread_id(void)
+{
+	if (!thread_id) {
+		thread_id = atomic_fetch_add(&nr_threads, 1) + 1;
+		g_string_append_printf(events, ",\n{\"name\":\"thread_name\","
+			"\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+			"\"args\":{\"name\":\"%s\"}}", (int)getpid(), thread_id,
+			thread_id == 1 ? "main" : "worker");
+	}
+	return thread_id;
+}
+
+void
+trace_init(void)
+{
+	const char *env = getenv("LABWC_MENU_GENERATOR_TRACE");
+	if (!env || !*env) {
+		return;
+	}
+	filename = g_strdup(env);
+	events = g_string_new("{\"traceEvents\":[\n"
+		"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":");
+	g_string_append_printf(events, "%d,\"args\":{\"name\":"
+		"\"labwc-menu-generator\"}}", (int)getpid());
+	epoch = now_ns();
+	get_thread_id();
+}
+
+uint64_t
+trace_begin(void)
+{
+	return events ? now_ns() : 0;
+}
+
+void
+trace_end(const char *cat, const char *name, uint64_t start)
+{
+	if (!events) {
+		return;
+	}
+	uint64_t end = now_ns();
+	g_mutex_lock(&lock);
+	int tid = get_thread_id();
+	g_string_append(events, ",\n{\"name\":");
+	json_append_string(events, name);
+	g_string_append_printf(events, ",\"cat\":\"%s\",\"ph\":\"X\","
+		"\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}", cat,
+		(start - epoch) / 1e3, (end - start) / 1e3, (int)getpid(), tid);
+	g_mutex_unlock(&lock);
+}
+
+void
+trace_finish(void)
+{
+	if (!events) {
+		return;
+	}
+	g_string_append(events, "\n],\"displayTimeUnit\":\"ms\"}\n");
+	GError *err = NULL;
+	if (!g_file_set_contents(filename, events->str, events->len, &err)) {
+		fprintf(stderr, "warn: cannot write trace: %s\n", err->message);
+		g_error_free(err);
+	}
+	g_string_free(events, TRUE);
+	events = NULL;
+	g_free(filename);
+	filename = NULL;
+}
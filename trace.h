@@ -0,0 +1,27 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef TRACE_H
+#define TRACE_H
+#include <stdint.h>
+
+/*
+ * Spans in the Chrome trace event format, which Perfetto and
+ * chrome://tracing load. Tracing is enabled by naming the output file in
+ * $LABWC_MENU_GENERATOR_TRACE, and spans may be recorded from any thread.
+ */
+
+/* trace_init - start tracing if $LABWC_MENU_GENERATOR_TRACE is set */
+void trace_init(void);
+
+/* trace_begin - return the start time of a span, or 0 if disabled */
+uint64_t trace_begin(void);
+
+/*
+ * trace_end - record span @name in category @cat from @start until now.
+ * @name is copied, so may be a path.
+ */
+void trace_end(const char *cat, const char *name, uint64_t start);
+
+/* trace_finish - write the trace file */
+void trace_finish(void);
+
+#endif /* TRACE_H */
@@ -0,0 +1,319 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Batched reads of whole files with io_uring
+ *
+ * The ring is driven with the raw system calls, so there is no dependency
+ * on liburing. Each batch goes through three rounds: the files are opened,
+ * then read, with each read handed over as soon as it completes, and then
+ * closed. Only the scanner thread uses the ring.
+ */
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "uring-reader.h"
+
+#ifdef HAVE_IO_URING
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define RING_ENTRIES 64
+
+struct uring_reader {
+	int fd;
+	unsigned int entries;
+	_Atomic unsigned int *sq_head, *sq_tail;
+	unsigned int *sq_mask, *sq_array;
+	_Atomic unsigned int *cq_head, *cq_tail;
+	unsigned int *cq_mask;
+	struct io_uring_sqe *sqes;
+	struct io_uring_cqe *cqes;
+	/* The tail of the SQEs handed out but not yet published */
+	unsigned int sq_local_tail;
+	/* Set once io_uring_enter() has failed, after which it is not used */
+	bool failed;
+	void *sq_map;
+	size_t sq_map_size, sqes_size;
+};
+
+static const int required_ops[] = {
+	IORING_OP_OPENAT,
+	IORING_OP_READ,
+	IORING_OP_CLOSE,
+};
+
+static bool
+has_required_ops(int fd)
+{
+	size_t size = sizeof(struct io_uring_probe)
+		+ 256 * sizeof(struct io_uring_probe_op);
+	struct io_uring_probe *probe = g_malloc0(size);
+	bool ok = syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE,
+		probe, 256) == 0;
+	for (size_t i = 0; ok && i < G_N_ELEMENTS(required_ops); i++) {
+		int op = required_ops[i];
+		ok = op <= probe->last_op
+			&& (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+	}
+	g_free(probe);
+	return ok;
+}
+
+struct uring_reader *
+uring_reader_create(void)
+{
+	struct io_uring_params params = { 0 };
+	int fd = syscall(__NR_io_uring_setup, RING_ENTRIES, &params);
+	if (fd == -1) {
+		return NULL;
+	}
+	if (!(params.features & IORING_FEAT_SINGLE_MMAP)
+			|| !has_required_ops(fd)) {
+		close(fd);
+		return NULL;
+	}
+
+	struct uring_reader *reader = g_new0(struct uring_reader, 1);
+	reader->fd = fd;
+	reader->entries = params.sq_entries;
+	reader->sq_map_size = MAX(
+		params.sq_off.array + params.sq_entries * sizeof(unsigned int),
+		params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe));
+	reader->sq_map = mmap(NULL, reader->sq_map_size, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	reader->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	reader->sqes = mmap(NULL, reader->sqes_size, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+	if (reader->sq_map == MAP_FAILED || reader->sqes == MAP_FAILED) {
+		if (reader->sq_map != MAP_FAILED) {
+			munmap(reader->sq_map, reader->sq_map_size);
+		}
+		close(fd);
+		g_free(reader);
+		return NULL;
+	}
+
+	/* The rings share one mapping */
+	char *sq = reader->sq_map, *cq = reader->sq_map;
+	reader->sq_head = (void *)(sq + params.sq_off.head);
+	reader->sq_tail = (void *)(sq + params.sq_off.tail);
+	reader->sq_mask = (void *)(sq + params.sq_off.ring_mask);
+	reader->sq_array = (void *)(sq + params.sq_off.array);
+	reader->cq_head = (void *)(cq + params.cq_off.head);
+	reader->cq_tail = (void *)(cq + params.cq_off.tail);
+	reader->cq_mask = (void *)(cq + params.cq_off.ring_mask);
+	reader->cqes = (void *)(cq + params.cq_off.cqes);
+	reader->sq_local_tail = atomic_load(reader->sq_tail);
+	return reader;
+}
+
+void
+uring_reader_destroy(struct uring_reader *reader)
+{
+	if (!reader) {
+		return;
+	}
+	munmap(reader->sqes, reader->sqes_size);
+	munmap(reader->sq_map, reader->sq_map_size);
+	close(reader->fd);
+	g_free(reader);
+}
+
+/* Batches are no larger than the ring, so there is always an SQE */
+static struct io_uring_sqe *
+get_sqe(struct uring_reader *reader, uint8_t opcode, int fd, uint64_t user_data)
+{
+	unsigned int index = reader->sq_local_tail++ & *reader->sq_mask;
+	struct io_uring_sqe *sqe = &reader->sqes[index];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = opcode;
+	sqe->fd = fd;
+	sqe->user_data = user_data;
+	reader->sq_array[index] = index;
+	return sqe;
+}
+
+/*
+ * Submit any new SQEs and wait for a completion if there is none. Returns
+ * false if the ring has failed.
+ */
+static bool
+wait_cqe(struct uring_reader *reader, struct io_uring_cqe *cqe)
+{
+	atomic_store_explicit(reader->sq_tail, reader->sq_local_tail,
+		memory_order_release);
+	for (;;) {
+		unsigned int head = atomic_load_explicit(reader->cq_head,
+			memory_order_relaxed);
+		if (head != atomic_load_explicit(reader->cq_tail,
+				memory_order_acquire)) {
+			*cqe = reader->cqes[head & *reader->cq_mask];
+			atomic_store_explicit(reader->cq_head, head + 1,
+				memory_order_release);
+			return true;
+		}
+		unsigned int to_submit = reader->sq_local_tail
+			- atomic_load_explicit(reader->sq_head, memory_order_acquire);
+		if (syscall(__NR_io_uring_enter, reader->fd, to_submit, 1,
+				IORING_ENTER_GETEVENTS, NULL, 0) == -1
+				&& errno != EINTR && errno != EAGAIN
+				&& errno != EBUSY) {
+			fprintf(stderr, "warn: io_uring_enter: %s\n",
+				strerror(errno));
+			reader->failed = true;
+			return false;
+		}
+	}
+}
+
+static int
+compare_ino(const void *a, const void *b)
+{
+	const struct uring_read *x = a, *y = b;
+	return (x->ino > y->ino) - (x->ino < y->ino);
+}
+
+static void
+run_batch(struct uring_reader *reader, struct uring_read *reads,
+		unsigned int nr, uring_read_func done)
+{
+	int fds[RING_ENTRIES];
+	bool is_done[RING_ENTRIES] = { 0 };
+	struct io_uring_cqe cqe;
+
+	for (unsigned int i = 0; i < nr; i++) {
+		struct io_uring_sqe *sqe = get_sqe(reader, IORING_OP_OPENAT,
+			AT_FDCWD, i);
+		sqe->addr = (uintptr_t)reads[i].path;
+		sqe->open_flags = O_RDONLY | O_CLOEXEC;
+	}
+	for (unsigned int i = 0; i < nr; i++) {
+		fds[i] = -1;
+	}
+	for (unsigned int i = 0; i < nr; i++) {
+		if (!wait_cqe(reader, &cqe)) {
+			goto fail;
+		}
+		fds[cqe.user_data] = cqe.res;
+	}
+
+	unsigned int nr_reads = 0;
+	for (unsigned int i = 0; i < nr; i++) {
+		reads[i].buf = NULL;
+		reads[i].len = 0;
+		if (fds[i] < 0) {
+			is_done[i] = true;
+			done(&reads[i]);
+			continue;
+		}
+		reads[i].buf = g_malloc(reads[i].size + 2);
+		struct io_uring_sqe *sqe = get_sqe(reader, IORING_OP_READ,
+			fds[i], i);
+		sqe->addr = (uintptr_t)reads[i].buf;
+		sqe->len = reads[i].size + 1;
+		sqe->off = 0;
+		nr_reads++;
+	}
+	for (unsigned int i = 0; i < nr_reads; i++) {
+		if (!wait_cqe(reader, &cqe)) {
+			goto fail;
+		}
+		struct uring_read *read = &reads[cqe.user_data];
+		/*
+		 * A short read, which network filesystems may return, is not
+		 * taken for the whole file. The file is read again instead.
+		 */
+		if (cqe.res >= 0 && (size_t)cqe.res == read->size) {
+			read->len = cqe.res;
+			read->buf[read->len] = '\0';
+		} else {
+			g_free(read->buf);
+			read->buf = NULL;
+		}
+		is_done[cqe.user_data] = true;
+		done(read);
+	}
+
+	unsigned int nr_closes = 0;
+	for (unsigned int i = 0; i < nr; i++) {
+		if (fds[i] >= 0) {
+			get_sqe(reader, IORING_OP_CLOSE, fds[i], i);
+			nr_closes++;
+		}
+	}
+	for (unsigned int i = 0; i < nr_closes; i++) {
+		if (!wait_cqe(reader, &cqe)) {
+			return;
+		}
+	}
+	return;
+
+fail:
+	/*
+	 * Reads in flight could still land in their buffers, so those are
+	 * leaked rather than freed. The files are read again without the ring.
+	 */
+	for (unsigned int i = 0; i < nr; i++) {
+		if (fds[i] >= 0) {
+			close(fds[i]);
+		}
+		if (!is_done[i]) {
+			reads[i].buf = NULL;
+			reads[i].len = 0;
+			done(&reads[i]);
+		}
+	}
+}
+
+void
+uring_reader_run(struct uring_reader *reader, struct uring_read *reads,
+		unsigned int nr, uring_read_func done)
+{
+	/* Inode order roughly follows the disk layout */
+	qsort(reads, nr, sizeof(*reads), compare_ino);
+	unsigned int batch = MIN(reader->entries, RING_ENTRIES);
+	unsigned int i = 0;
+	for (; i < nr && !reader->failed; i += batch) {
+		run_batch(reader, reads + i, MIN(batch, nr - i), done);
+	}
+	/* The files left once the ring has failed are read without it */
+	for (; i < nr; i++) {
+		reads[i].buf = NULL;
+		reads[i].len = 0;
+		done(&reads[i]);
+	}
+}
+
+#else
+
+struct uring_reader *
+uring_reader_create(void)
+{
+	return NULL;
+}
+
+void
+uring_reader_destroy(struct uring_reader *reader)
+{
+	(void)reader;
+}
+
+void
+uring_reader_run(struct uring_reader *reader, struct uring_read *reads,
+		unsigned int nr, uring_read_func done)
+{
+	(void)reader;
+	(void)reads;
+	(void)nr;
+	(void)done;
+}
+
+#endif /* HAVE_IO_URING */
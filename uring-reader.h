@@ -0,0 +1,43 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef URING_READER_H
+#define URING_READER_H
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Reads whole files with io_uring, keeping many opens and reads in flight
+ * at once so that slow devices see a deep queue rather than one request
+ * at a time.
+ */
+struct uring_reader;
+
+struct uring_read {
+	const char *path;
+	uint64_t ino;
+	/* The expected size. One more byte is read to notice files growing. */
+	size_t size;
+	/* The NUL-terminated contents, or NULL if the file has to be read again */
+	char *buf;
+	size_t len;
+	void *data;
+};
+
+/* Called for each read as it completes. @read->buf is passed on. */
+typedef void (*uring_read_func)(struct uring_read *read);
+
+/*
+ * uring_reader_create - set up a ring. Returns NULL if io_uring or the
+ * operations it needs are not available, for example on older kernels or
+ * in sandboxes which block it.
+ */
+struct uring_reader *uring_reader_create(void);
+void uring_reader_destroy(struct uring_reader *reader);
+
+/*
+ * uring_reader_run - read the @nr files of @reads in batches, submitted in
+ * inode order, and call @done for each one
+ */
+void uring_reader_run(struct uring_reader *reader, struct uring_read *reads,
+	unsigned int nr, uring_read_func done);
+
+#endif /* URING_READER_H */
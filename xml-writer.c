@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Escape and write XML
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <glib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "xml-writer.h"
+
+/*
+ * Attribute values are always double-quoted, so an apostrophe needs no
+ * escaping anywhere in the menu.
+ */
+#define XML_SPECIAL "&<>\""
+
+void
+xml_append_escaped(GString *buf, const char *s)
+{
+	if (!s) {
+		return;
+	}
+	for (;;) {
+		size_t len = strcspn(s, XML_SPECIAL);
+		g_string_append_len(buf, s, len);
+		s += len;
+		switch (*s) {
+		case '&':
+			xml_append_literal(buf, "&amp;");
+			break;
+		case '<':
+			xml_append_literal(buf, "&lt;");
+			break;
+		case '>':
+			xml_append_literal(buf, "&gt;");
+			break;
+		case '"':
+			xml_append_literal(buf, "&quot;");
+			break;
+		default:
+			return;
+		}
+		s++;
+	}
+}
+
+bool
+xml_writev(int fd, struct iovec *iov, int iovcnt)
+{
+	for (;;) {
+		/* Skip what has been written so far */
+		while (iovcnt && !iov->iov_len) {
+			iov++;
+			iovcnt--;
+		}
+		if (!iovcnt) {
+			return true;
+		}
+		ssize_t n = writev(fd, iov, iovcnt);
+		if (n == -1 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			return false;
+		}
+		for (; n > 0; iov++, iovcnt--) {
+			size_t len = MIN((size_t)n, iov->iov_len);
+			iov->iov_base = (char *)iov->iov_base + len;
+			iov->iov_len -= len;
+			n -= len;
+			if (iov->iov_len) {
+				break;
+			}
+		}
+	}
+}
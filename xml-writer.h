@@ -0,0 +1,30 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef XML_WRITER_H
+#define XML_WRITER_H
+#include <glib.h>
+#include <stdbool.h>
+#include <sys/uio.h>
+
+/*
+ * The menu is written into a GString in a single pass. Literal markup is
+ * appended with its length known at compile time and text is escaped as it
+ * is copied.
+ */
+
+/* xml_append_literal - append the string literal @s */
+#define xml_append_literal(buf, s) \
+	g_string_append_len((buf), "" s, sizeof(s) - 1)
+
+/*
+ * xml_append_escaped - append @s with &, <, > and " replaced by entities.
+ * Nothing is appended if @s is NULL.
+ */
+void xml_append_escaped(GString *buf, const char *s);
+
+/*
+ * xml_writev - write all of @iov to @fd, returning false on error. @iov is
+ * updated as partial writes progress.
+ */
+bool xml_writev(int fd, struct iovec *iov, int iovcnt);
+
+#endif /* XML_WRITER_H */